@@ -0,0 +1,516 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+#include "benchmark/benchmark.h"
+#include "../include/processing_scheduling.h"
+
+// Using a C library requires extern "C" to prevent function mangling
+extern "C"
+{
+#include <dyn_arena.h>
+#include <dyn_array.h>
+#include <pcb_columns.h>
+#include <fcfs_kernel.h>
+#include <schedule_timeline.h>
+#include <sim_engine.h>
+}
+
+// Burst length distributions the workloads are drawn from
+enum BurstDistribution {
+    BURST_UNIFORM = 0,      // 1..100, every job about the same size
+    BURST_EXPONENTIAL = 1,  // mean 50, lots of short jobs
+    BURST_PARETO = 2,       // heavy tail, a few enormous jobs dominate
+};
+
+/*
+ Helper function
+ Builds a ready queue of n PCBs with bursts from the given distribution
+ and arrivals spread over the run, back of the queue first like the loader
+*/
+static dyn_array_t* make_queue(size_t n, int distribution, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<uint32_t> uniform(1, 100);
+    std::exponential_distribution<double> exponential(1.0 / 50.0);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::uniform_int_distribution<uint32_t> arrival(0, (uint32_t)(n * 50 < UINT32_MAX ? n * 50 : UINT32_MAX));
+    std::uniform_int_distribution<uint32_t> priority(0, 31);
+
+    dyn_array_t* queue = dyn_array_create(n, sizeof(ProcessControlBlock_t), nullptr);
+    for (size_t i = 0; i < n; ++i) {
+        double burst;
+        switch (distribution) {
+            case BURST_EXPONENTIAL:
+                burst = 1.0 + exponential(rng);
+                break;
+            case BURST_PARETO:
+                // alpha 1.2, minimum 10, capped so it still fits in 32 bits
+                burst = 10.0 / std::pow(1.0 - unit(rng), 1.0 / 1.2);
+                if (burst > 1e9)
+                    burst = 1e9;
+                break;
+            default:
+                burst = uniform(rng);
+                break;
+        }
+
+        ProcessControlBlock_t pcb;
+        pcb.remaining_burst_time = (uint32_t)burst;
+        pcb.priority = priority(rng);
+        pcb.arrival = arrival(rng);
+        pcb.started = false;
+        dyn_array_push_back(queue, &pcb);
+    }
+    return queue;
+}
+
+static int compare_arrival(const void* a, const void* b) {
+    const ProcessControlBlock_t* lhs = (const ProcessControlBlock_t*)a;
+    const ProcessControlBlock_t* rhs = (const ProcessControlBlock_t*)b;
+    return (lhs->arrival > rhs->arrival) - (lhs->arrival < rhs->arrival);
+}
+
+// N from 10 to 10^7 for linear and n log n paths
+static void LinearSizes(benchmark::internal::Benchmark* b) {
+    b->ArgsProduct({benchmark::CreateRange(10, 10000000, 10), {BURST_UNIFORM, BURST_EXPONENTIAL, BURST_PARETO}});
+    b->ArgNames({"n", "dist"});
+    b->Unit(benchmark::kMillisecond);
+}
+
+// The quadratic dyn_array paths stop at 10^5, past that a single iteration takes minutes
+static void QuadraticSizes(benchmark::internal::Benchmark* b) {
+    b->RangeMultiplier(10)->Range(10, 100000);
+    b->ArgName("n");
+    b->Unit(benchmark::kMillisecond);
+}
+
+/*
+ Scheduler harness
+ Each iteration schedules a fresh copy of the same queue, the copy is not timed
+ With backlog set every job arrives at 0, so all n are ready at once
+*/
+template <typename Scheduler>
+static void run_scheduler(benchmark::State& state, Scheduler schedule, bool backlog = false) {
+    const size_t n = (size_t)state.range(0);
+    dyn_array_t* source = make_queue(n, (int)state.range(1), 42);
+    for (size_t i = 0; backlog && i < n; ++i)
+        ((ProcessControlBlock_t*)dyn_array_at(source, i))->arrival = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        dyn_array_t* queue = dyn_array_clone(source);
+        state.ResumeTiming();
+
+        ScheduleResult_t result;
+        benchmark::DoNotOptimize(schedule(queue, &result));
+
+        state.PauseTiming();
+        dyn_array_destroy(queue);
+        state.ResumeTiming();
+    }
+    dyn_array_destroy(source);
+    state.SetComplexityN(state.range(0));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_FirstComeFirstServe(benchmark::State& state) {
+    run_scheduler(state, first_come_first_serve);
+}
+BENCHMARK(BM_FirstComeFirstServe)->Apply(LinearSizes);
+
+static void BM_ShortestJobFirst(benchmark::State& state) {
+    run_scheduler(state, shortest_job_first);
+}
+BENCHMARK(BM_ShortestJobFirst)->Apply(LinearSizes);
+
+// the same schedule read straight out of one shared queue, with no copy to make between iterations
+static void BM_ShortestJobFirstView(benchmark::State& state) {
+    const size_t n = (size_t)state.range(0);
+    dyn_array_t* source = make_queue(n, (int)state.range(1), 42);
+    PcbView_t view;
+    pcb_view_from_queue(&view, source);
+    for (auto _ : state) {
+        ScheduleResult_t result;
+        benchmark::DoNotOptimize(shortest_job_first_view(&view, &result, nullptr));
+    }
+    dyn_array_destroy(source);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ShortestJobFirstView)->Apply(LinearSizes);
+
+// one sweep worker's view of round robin, scratch from the heap (0) or from an arena reset between runs (1)
+static void BM_RoundRobinViewScratch(benchmark::State& state) {
+    const size_t n = (size_t)state.range(0);
+    dyn_array_t* source = make_queue(n, BURST_EXPONENTIAL, 42);
+    PcbView_t view;
+    pcb_view_from_queue(&view, source);
+    dyn_arena_t* arena = dyn_arena_create(0);
+    dyn_allocator_t allocator;
+    if (state.range(1) && dyn_arena_allocator(arena, &allocator))
+        sim_set_scratch_allocator(&allocator);
+    for (auto _ : state) {
+        ScheduleResult_t result;
+        benchmark::DoNotOptimize(round_robin_view(&view, &result, 4, nullptr));
+        dyn_arena_reset(arena);
+    }
+    sim_set_scratch_allocator(nullptr);
+    dyn_arena_destroy(arena);
+    dyn_array_destroy(source);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RoundRobinViewScratch)
+    ->ArgsProduct({benchmark::CreateRange(100, 1000000, 10), {0, 1}})
+    ->ArgNames({"n", "arena"})
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_Priority(benchmark::State& state) {
+    run_scheduler(state, priority);
+}
+BENCHMARK(BM_Priority)->Apply(LinearSizes);
+
+// preemptive with aging, and the same with every job ready at once
+static void BM_PriorityAging(benchmark::State& state) {
+    const PriorityConfig_t config = { true, 100 };
+    run_scheduler(state, [&](dyn_array_t* queue, ScheduleResult_t* result) {
+        return priority_detailed(queue, result, &config, nullptr);
+    });
+}
+BENCHMARK(BM_PriorityAging)->Apply(LinearSizes);
+
+static void BM_PriorityAgingBacklog(benchmark::State& state) {
+    const PriorityConfig_t config = { true, 100 };
+    run_scheduler(state, [&](dyn_array_t* queue, ScheduleResult_t* result) {
+        return priority_detailed(queue, result, &config, nullptr);
+    }, true);
+}
+BENCHMARK(BM_PriorityAgingBacklog)->Apply(LinearSizes);
+
+static void BM_RoundRobin(benchmark::State& state) {
+    run_scheduler(state, [](dyn_array_t* queue, ScheduleResult_t* result) { return round_robin(queue, result, 4); });
+}
+BENCHMARK(BM_RoundRobin)->Apply(LinearSizes);
+
+// the same run recording every slice to a timeline file, to weigh against BM_RoundRobin
+static void BM_RoundRobinTimeline(benchmark::State& state) {
+    FILE* f = tmpfile();
+    if (f == nullptr) {
+        state.SkipWithError("could not open a timeline file");
+        return;
+    }
+    int64_t bytes = 0;
+    run_scheduler(state, [&](dyn_array_t* queue, ScheduleResult_t* result) {
+        rewind(f);
+        schedule_timeline_writer_t* writer = schedule_timeline_writer_create(f);
+        ScheduleTimeline_t timeline;
+        schedule_timeline_to_writer(&timeline, writer);
+        ScheduleOutputs_t outputs = { &timeline, NULL };
+        bool success = round_robin_detailed(queue, result, 4, &outputs);
+        success = schedule_timeline_writer_finish(writer) && success;
+        bytes += ftell(f);
+        return success;
+    });
+    fclose(f);
+    state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_RoundRobinTimeline)->Apply(LinearSizes);
+
+// the same run collecting the tail stats, to weigh the histograms against BM_RoundRobin
+static void BM_RoundRobinStats(benchmark::State& state) {
+    run_scheduler(state, [](dyn_array_t* queue, ScheduleResult_t* result) {
+        ScheduleStats_t stats;
+        ScheduleOutputs_t outputs = { NULL, &stats };
+        return round_robin_detailed(queue, result, 4, &outputs);
+    });
+}
+BENCHMARK(BM_RoundRobinStats)->Apply(LinearSizes);
+
+// three levels with a boost, to weigh the per-level rings against BM_RoundRobin
+static void BM_MultilevelFeedbackQueue(benchmark::State& state) {
+    static const size_t quanta[] = { 4, 16, 64 };
+    const MlfqConfig_t config = { 3, quanta, 1000 };
+    run_scheduler(state, [&](dyn_array_t* queue, ScheduleResult_t* result) {
+        return multilevel_feedback_queue(queue, result, &config);
+    });
+}
+BENCHMARK(BM_MultilevelFeedbackQueue)->Apply(LinearSizes);
+
+// round robin on many cores, with a global queue (0) and with per-core queues and stealing (1)
+static void BM_RoundRobinSmp(benchmark::State& state) {
+    const size_t num_cores = (size_t)state.range(2);
+    const SmpQueueing_t queueing = (SmpQueueing_t)state.range(3);
+    std::vector<SmpCoreStats_t> cores(num_cores);
+    run_scheduler(state, [&](dyn_array_t* queue, ScheduleResult_t* result) {
+        return round_robin_smp(queue, result, 4, num_cores, queueing, cores.data());
+    });
+}
+BENCHMARK(BM_RoundRobinSmp)
+    ->ArgsProduct({benchmark::CreateRange(1000, 1000000, 10), {BURST_EXPONENTIAL}, {1, 8, 64}, {0, 1}})
+    ->ArgNames({"n", "dist", "cores", "queueing"})
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_ShortestRemainingTimeFirst(benchmark::State& state) {
+    run_scheduler(state, shortest_remaining_time_first);
+}
+BENCHMARK(BM_ShortestRemainingTimeFirst)->Apply(LinearSizes);
+
+/*
+ Loader over a PCB file of n records
+*/
+static void BM_LoadProcessControlBlocks(benchmark::State& state) {
+    const size_t n = (size_t)state.range(0);
+    const std::string path = "/tmp/hw2_bench_" + std::to_string(n) + ".bin";
+
+    dyn_array_t* source = make_queue(n, (int)state.range(1), 42);
+    FILE* f = fopen(path.c_str(), "wb");
+    if (f == nullptr) {
+        dyn_array_destroy(source);
+        state.SkipWithError("could not write the PCB file");
+        return;
+    }
+    uint32_t count = (uint32_t)n;
+    fwrite(&count, sizeof(uint32_t), 1, f);
+    for (size_t i = 0; i < n; ++i) {
+        const ProcessControlBlock_t* pcb = (const ProcessControlBlock_t*)dyn_array_at(source, i);
+        uint32_t record[3] = {pcb->remaining_burst_time, pcb->priority, pcb->arrival};
+        fwrite(record, sizeof(uint32_t), 3, f);
+    }
+    fclose(f);
+    dyn_array_destroy(source);
+
+    for (auto _ : state) {
+        dyn_array_t* loaded = load_process_control_blocks(path.c_str());
+        benchmark::DoNotOptimize(loaded);
+        dyn_array_destroy(loaded);
+    }
+    remove(path.c_str());
+    state.SetComplexityN(state.range(0));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * (int64_t)(n * 3 * sizeof(uint32_t)));
+}
+BENCHMARK(BM_LoadProcessControlBlocks)->Apply(LinearSizes);
+
+/*
+ Hot dyn_array operations on PCB-sized elements
+*/
+static void BM_DynArrayPushFront(benchmark::State& state) {
+    const size_t n = (size_t)state.range(0);
+    ProcessControlBlock_t pcb = {1, 2, 3, false};
+    for (auto _ : state) {
+        dyn_array_t* queue = dyn_array_create(0, sizeof(ProcessControlBlock_t), nullptr);
+        for (size_t i = 0; i < n; ++i)
+            dyn_array_push_front(queue, &pcb);
+        benchmark::DoNotOptimize(dyn_array_front(queue));
+        dyn_array_destroy(queue);
+    }
+    state.SetComplexityN(state.range(0));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DynArrayPushFront)->Apply(QuadraticSizes)->Complexity(benchmark::oNSquared);
+
+static void BM_DynArrayInsertSorted(benchmark::State& state) {
+    const size_t n = (size_t)state.range(0);
+    dyn_array_t* source = make_queue(n, BURST_UNIFORM, 42);
+    for (auto _ : state) {
+        dyn_array_t* queue = dyn_array_create(0, sizeof(ProcessControlBlock_t), nullptr);
+        for (size_t i = 0; i < n; ++i)
+            dyn_array_insert_sorted(queue, dyn_array_at(source, i), compare_arrival);
+        benchmark::DoNotOptimize(dyn_array_front(queue));
+        dyn_array_destroy(queue);
+    }
+    dyn_array_destroy(source);
+    state.SetComplexityN(state.range(0));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DynArrayInsertSorted)->Apply(QuadraticSizes)->Complexity(benchmark::oNSquared);
+
+static void BM_DynArrayExtractBack(benchmark::State& state) {
+    const size_t n = (size_t)state.range(0);
+    dyn_array_t* source = make_queue(n, (int)state.range(1), 42);
+    for (auto _ : state) {
+        state.PauseTiming();
+        dyn_array_t* queue = dyn_array_clone(source);
+        state.ResumeTiming();
+
+        ProcessControlBlock_t pcb;
+        while (dyn_array_extract_back(queue, &pcb))
+            benchmark::DoNotOptimize(pcb);
+
+        state.PauseTiming();
+        dyn_array_destroy(queue);
+        state.ResumeTiming();
+    }
+    dyn_array_destroy(source);
+    state.SetComplexityN(state.range(0));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DynArrayExtractBack)->Apply(LinearSizes);
+
+static void BM_DynArraySort(benchmark::State& state) {
+    const size_t n = (size_t)state.range(0);
+    dyn_array_t* source = make_queue(n, (int)state.range(1), 42);
+    for (auto _ : state) {
+        state.PauseTiming();
+        dyn_array_t* queue = dyn_array_clone(source);
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(dyn_array_sort(queue, compare_arrival));
+
+        state.PauseTiming();
+        dyn_array_destroy(queue);
+        state.ResumeTiming();
+    }
+    dyn_array_destroy(source);
+    state.SetComplexityN(state.range(0));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DynArraySort)->Apply(LinearSizes);
+
+// the same sort by arrival as BM_DynArraySort, radix passes over the key instead of comparisons
+static void BM_DynArraySortByKey(benchmark::State& state) {
+    const size_t n = (size_t)state.range(0);
+    dyn_array_t* source = make_queue(n, (int)state.range(1), 42);
+    for (auto _ : state) {
+        state.PauseTiming();
+        dyn_array_t* queue = dyn_array_clone(source);
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(dyn_array_sort_by_key(queue, offsetof(ProcessControlBlock_t, arrival), sizeof(uint32_t)));
+
+        state.PauseTiming();
+        dyn_array_destroy(queue);
+        state.ResumeTiming();
+    }
+    dyn_array_destroy(source);
+    state.SetComplexityN(state.range(0));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DynArraySortByKey)->Apply(LinearSizes);
+
+// filling a queue one push at a time against one bulk append of the whole run
+static void BM_DynArrayPushBack(benchmark::State& state) {
+    const size_t n = (size_t)state.range(0);
+    dyn_array_t* source = make_queue(n, (int)state.range(1), 42);
+    const ProcessControlBlock_t* pcbs = (const ProcessControlBlock_t*)dyn_array_export(source);
+    for (auto _ : state) {
+        dyn_array_t* queue = dyn_array_create(0, sizeof(ProcessControlBlock_t), nullptr);
+        for (size_t i = 0; i < n; ++i)
+            dyn_array_push_back(queue, &pcbs[i]);
+        benchmark::DoNotOptimize(dyn_array_back(queue));
+        dyn_array_destroy(queue);
+    }
+    dyn_array_destroy(source);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DynArrayPushBack)->Apply(LinearSizes);
+
+static void BM_DynArrayPushBackN(benchmark::State& state) {
+    const size_t n = (size_t)state.range(0);
+    dyn_array_t* source = make_queue(n, (int)state.range(1), 42);
+    for (auto _ : state) {
+        dyn_array_t* queue = dyn_array_create(0, sizeof(ProcessControlBlock_t), nullptr);
+        dyn_array_push_back_n(queue, dyn_array_export(source), n);
+        benchmark::DoNotOptimize(dyn_array_back(queue));
+        dyn_array_destroy(queue);
+    }
+    dyn_array_destroy(source);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DynArrayPushBackN)->Apply(LinearSizes);
+
+// draining the front in runs of 64, each run moves the rest of the queue up once rather than 64 times
+static void BM_DynArrayExtractFrontN(benchmark::State& state) {
+    const size_t n = (size_t)state.range(0);
+    dyn_array_t* source = make_queue(n, BURST_UNIFORM, 42);
+    ProcessControlBlock_t run[64];
+    for (auto _ : state) {
+        state.PauseTiming();
+        dyn_array_t* queue = dyn_array_clone(source);
+        state.ResumeTiming();
+
+        while (!dyn_array_empty(queue)) {
+            size_t count = std::min(dyn_array_size(queue), (size_t)64);
+            dyn_array_extract_front_n(queue, run, count);
+            benchmark::DoNotOptimize(run);
+        }
+
+        state.PauseTiming();
+        dyn_array_destroy(queue);
+        state.ResumeTiming();
+    }
+    dyn_array_destroy(source);
+    state.SetComplexityN(state.range(0));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DynArrayExtractFrontN)->Apply(QuadraticSizes)->Complexity(benchmark::oNSquared);
+
+/*
+ FCFS closed form straight over the array of structs, to set against BM_FcfsKernel over the columns
+ Build with -DCMAKE_BUILD_TYPE=Release, the unoptimised default vectorizes neither
+*/
+static void BM_FcfsAoS(benchmark::State& state) {
+    const size_t n = (size_t)state.range(0);
+    dyn_array_t* queue = make_queue(n, BURST_EXPONENTIAL, 42);
+    const ProcessControlBlock_t* pcbs = (const ProcessControlBlock_t*)dyn_array_export(queue);
+    for (auto _ : state) {
+        uint64_t finish = 0, total_turnaround = 0;
+        for (size_t i = n; i-- > 0;) {
+            finish = std::max<uint64_t>(finish, pcbs[i].arrival) + pcbs[i].remaining_burst_time;
+            total_turnaround += finish - pcbs[i].arrival;
+        }
+        benchmark::DoNotOptimize(finish);
+        benchmark::DoNotOptimize(total_turnaround);
+    }
+    dyn_array_destroy(queue);
+    state.SetComplexityN(state.range(0));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FcfsAoS)->RangeMultiplier(10)->Range(10, 10000000)->Unit(benchmark::kMillisecond);
+
+// the one-off cost of the split, to weigh against what the column kernels save
+static void BM_ColumnsFromQueue(benchmark::State& state) {
+    const size_t n = (size_t)state.range(0);
+    dyn_array_t* queue = make_queue(n, (int)state.range(1), 42);
+    for (auto _ : state) {
+        PcbColumns_t* columns = pcb_columns_from_queue(queue);
+        benchmark::DoNotOptimize(columns);
+        pcb_columns_destroy(columns);
+    }
+    dyn_array_destroy(queue);
+    state.SetComplexityN(state.range(0));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ColumnsFromQueue)->Apply(LinearSizes);
+
+/*
+ FCFS closed form, one kernel at a time over the same columns
+ fcfs_kernel_best only picks a vector kernel whose items/s here beat scalar at
+ every n, a new kernel that doesn't has no place in it
+*/
+static void BM_FcfsKernel(benchmark::State& state) {
+    const size_t n = (size_t)state.range(0);
+    const FcfsKernel_t kernel = (FcfsKernel_t)state.range(1);
+    if (!fcfs_kernel_supported(kernel)) {
+        state.SkipWithError("kernel not supported on this CPU");
+        return;
+    }
+    dyn_array_t* queue = make_queue(n, BURST_EXPONENTIAL, 42);
+    PcbColumns_t* columns = pcb_columns_from_queue(queue);
+    for (auto _ : state) {
+        FcfsTotals_t totals;
+        benchmark::DoNotOptimize(fcfs_kernel_run(kernel, columns, &totals));
+        benchmark::DoNotOptimize(totals);
+    }
+    pcb_columns_destroy(columns);
+    dyn_array_destroy(queue);
+    state.SetComplexityN(state.range(0));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FcfsKernel)
+    ->ArgsProduct({benchmark::CreateRange(10, 10000000, 10), {FCFS_KERNEL_SCALAR, FCFS_KERNEL_AVX512}})
+    ->ArgNames({"n", "kernel"})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
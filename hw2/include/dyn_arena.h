@@ -0,0 +1,89 @@
+#ifndef DYN_ARENA_H
+#define DYN_ARENA_H
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "dyn_array.h"
+
+typedef struct dyn_arena dyn_arena_t;
+
+/*
+	Companion to dyn_array: a bump (arena) allocator for short-lived scratch.
+
+	Allocating is a pointer bump inside a block, so it never touches malloc
+	once the arena has grown to what a workload needs. Freeing individual
+	allocations is a no-op, except the most recent one, which can also be
+	grown in place. That's exactly how a dyn_array on an arena uses it.
+
+	Reset notes!
+
+	dyn_arena_reset throws away everything at once in O(1) and keeps every block
+	for the next round, so a loop that resets between rounds stops calling
+	malloc after the first one. Anything still allocated from the arena is
+	garbage after a reset, destroy arrays on it before resetting.
+
+	An arena is not thread safe, give each thread its own.
+*/
+
+///
+/// Creates an empty arena, blocks are only allocated once something is
+/// \param block_size Minimum size of each block in bytes (0 for a default of 1 MiB), bigger requests get their own
+/// \return new arena pointer, NULL on error
+///
+dyn_arena_t *dyn_arena_create(const size_t block_size);
+
+///
+/// Arena destructor, frees every block and so everything allocated from it
+/// \param dyn_arena The arena to destruct
+///
+void dyn_arena_destroy(dyn_arena_t *const dyn_arena);
+
+///
+/// Allocates size bytes, aligned for any type
+/// \param dyn_arena the arena
+/// \param size bytes to allocate
+/// \return pointer to the memory, NULL on error
+///
+void *dyn_arena_alloc(dyn_arena_t *const dyn_arena, const size_t size);
+
+///
+/// Releases everything allocated so far in O(1), keeping the blocks for reuse
+/// \param dyn_arena the arena
+///
+void dyn_arena_reset(dyn_arena_t *const dyn_arena);
+
+///
+/// Fills in an allocator that places memory in the arena, for dyn_array_create_with_allocator and friends
+/// \param dyn_arena the arena, must outlive everything created with the allocator
+/// \param allocator destination for the allocator
+/// \return bool representing success of the operation
+///
+bool dyn_arena_allocator(dyn_arena_t *const dyn_arena, dyn_allocator_t *const allocator);
+
+///
+/// Returns the number of blocks the arena holds, a count of the mallocs it has made
+/// \param dyn_arena the arena
+/// \return number of blocks, 0 on error
+///
+size_t dyn_arena_blocks(const dyn_arena_t *const dyn_arena);
+
+///
+/// Returns the bytes handed out since the last reset, alignment padding included
+/// \param dyn_arena the arena
+/// \return bytes in use, 0 on error
+///
+size_t dyn_arena_used(const dyn_arena_t *const dyn_arena);
+
+#ifdef __cplusplus
+  }
+#endif
+
+#endif
@@ -12,7 +12,32 @@
 #include <stdint.h>
 
 typedef struct dyn_array dyn_array_t;
-// Next version, push/pop_N_back/front for bulk loading
+
+///
+/// Where an array gets its memory from, set once at creation with dyn_array_create_with_allocator
+/// Every call gets the context back, and the sizes the array asked for so a bump allocator needs no headers
+/// A NULL allocator means malloc, realloc and free
+///
+typedef struct
+{
+	void *(*allocate)(void *context, size_t size);
+	void *(*reallocate)(void *context, void *ptr, size_t old_size, size_t new_size);
+	void (*release)(void *context, void *ptr, size_t size);
+	void *context;
+} dyn_allocator_t;
+
+///
+/// How an array grows and gives memory back, set per array with dyn_array_set_policy
+/// The defaults double on growth and never shrink on their own, same as before policies existed
+///
+typedef struct
+{
+	double growth_factor;		// capacity is multiplied by this when it runs out, more than 1
+	double shrink_threshold;	// shrink once size drops below this fraction of capacity, 0 never shrinks
+	size_t min_capacity;		// automatic shrinking stops here, at least 1
+	bool hugepage_align;		// heap allocations of 2 MiB or more are hugepage aligned, rounded up to whole pages
+} dyn_array_policy_t;
+// Next version, push_N_front/pop_N_back
 // Erase_n
 // etc
 
@@ -44,6 +69,33 @@ typedef struct dyn_array dyn_array_t;
 ///
 dyn_array_t *dyn_array_create(const size_t capacity, const size_t data_type_size, void (*destruct_func)(void *));
 
+///
+/// Same as dyn_array_create, with the array and its contents placed by the given allocator
+/// \param capacity Minimum capacity request (0 is fine if you have no opinion)
+/// \param data_type_size Size of the object type to be stored in bytes
+/// \param destruct_func Optional destructor to be applied on destruct operations (NULL to disable)
+/// \param allocator the allocator, copied, NULL for the heap; its context must outlive the array
+/// \return new dynamic array pointer, NULL on error
+///
+dyn_array_t *dyn_array_create_with_allocator(const size_t capacity, const size_t data_type_size,
+											 void (*destruct_func)(void *), const dyn_allocator_t *const allocator);
+
+///
+/// Fills in the default policy: doubling growth, no automatic shrinking, min capacity 16, no hugepages
+/// \param policy the policy to fill in
+///
+void dyn_array_policy_defaults(dyn_array_policy_t *const policy);
+
+///
+/// Replaces the growth and shrink policy of an array, applying it straight away
+/// The shrink threshold has to be below 1 / growth_factor, so a shrink leaves room for one growth
+/// and an array hovering around the threshold doesn't reallocate back and forth
+/// \param dyn_array the dynamic array
+/// \param policy the new policy, copied
+/// \return bool representing success of the operation, false for an invalid policy
+///
+bool dyn_array_set_policy(dyn_array_t *const dyn_array, const dyn_array_policy_t *const policy);
+
 ///
 /// Creates a new dynamic array from a given array
 /// (Given pointer can be freed after import, we copy the data)
@@ -146,6 +198,53 @@ bool dyn_array_pop_back(dyn_array_t *const dyn_array);
 ///
 bool dyn_array_extract_back(dyn_array_t *const dyn_array, void *const object);
 
+///
+/// Copies count objects and places them at the back of the array, in order, increasing container size by count
+/// Makes at most one reallocation and one copy, however many objects there are
+/// \param dyn_array the dynamic array
+/// \param objects the objects to insert, contiguous
+/// \param count the number of objects, 0 does nothing
+/// \return bool representing success of the operation
+///
+bool dyn_array_push_back_n(dyn_array_t *const dyn_array, const void *const objects, const size_t count);
+
+///
+/// Removes the first count objects of the array and places them in the desired location, in order
+/// Does not destruct since they were returned to the user
+/// The rest of the array moves up once, not once per object
+/// \param dyn_array the dynamic array
+/// \param objects destination for the extracted objects, room for count of them
+/// \param count the number of objects, at most the size of the array, 0 does nothing
+/// \return bool representing success of the operation
+///
+bool dyn_array_extract_front_n(dyn_array_t *const dyn_array, void *const objects, const size_t count);
+
+///
+/// Makes sure the array can hold at least capacity objects without reallocating
+/// Never shrinks the array, and grows it with a single reallocation if it has to
+/// A policy that shrinks may still give the room back on a later removal
+/// \param dyn_array the dynamic array
+/// \param capacity the number of objects to make room for
+/// \return bool representing success of the operation
+///
+bool dyn_array_reserve(dyn_array_t *const dyn_array, const size_t capacity);
+
+///
+/// Reallocates the array down to its current size (at least one object), giving back any spare capacity
+/// Keeps hugepage alignment if the policy asks for it and the array is still large enough
+/// \param dyn_array the dynamic array
+/// \return bool representing success of the operation, the array is unchanged on failure
+///
+bool dyn_array_shrink_to_fit(dyn_array_t *const dyn_array);
+
+///
+/// Creates a new dynamic array holding a copy of every object in the given one
+/// Objects are copied byte for byte, so with a destructor both arrays refer to the same resources
+/// \param dyn_array the dynamic array to copy
+/// \return new dynamic array pointer with the same data size, destructor, policy and allocator, NULL on error
+///
+dyn_array_t *dyn_array_clone(const dyn_array_t *const dyn_array);
+
 
 ///
 /// Returns a pointer to the desired object in the array
@@ -225,12 +324,25 @@ size_t dyn_array_data_size(const dyn_array_t *const dyn_array);
 /// compare(x,y) = 0 iff x == y
 /// compare(x,y) > 0 iff y > x
 /// Sort is not guaranteed to be stable
+/// Introsort, so O(n log n) even on adversarial input, swapping whole words for common object sizes
 /// \param dyn_array the dynamic array
 /// \param compare the comparison function
 /// \return bool representing success of the operation
 ///
 bool dyn_array_sort(dyn_array_t *const dyn_array, int (*const compare)(const void *, const void *));
 
+///
+/// Sorts the array ascending by an unsigned integer key stored inside every object, e.g. a PCB's arrival
+/// LSD radix sort, a byte per pass, skipping bytes every key shares, so linear in size and never calls a comparator
+/// Sort is stable, objects with equal keys keep their order
+/// Needs a scratch copy of the contents while it runs, from the array's allocator
+/// \param dyn_array the dynamic array
+/// \param key_offset offset of the key in each object in bytes, e.g. offsetof(ProcessControlBlock_t, arrival)
+/// \param key_size size of the key in bytes, 1, 2, 4 or 8, read in native byte order
+/// \return bool representing success of the operation
+///
+bool dyn_array_sort_by_key(dyn_array_t *const dyn_array, const size_t key_offset, const size_t key_size);
+
 
 ///
 /// Inserts the given object into the correct sorted position
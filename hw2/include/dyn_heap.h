@@ -0,0 +1,153 @@
+#ifndef DYN_HEAP_H
+#define DYN_HEAP_H
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+typedef struct dyn_heap dyn_heap_t;
+
+/*
+	Companion to dyn_array: a binary min-heap (priority queue) of
+	data_type_size-sized objects, ordered by a comparator given at creation.
+
+	Destructor notes are the same as dyn_array:
+	the optional destructor is set at creation, NULL disables it,
+	pop triggers it and extract avoids it.
+
+	Handle notes!
+
+	Every push hands back a handle that names that object until it leaves the heap.
+	Handles are small integers (below the high water mark of the heap size),
+	so callers can index their own side tables with them.
+	A handle is recycled once its object is popped or extracted.
+	Objects never move in memory while they are in the heap,
+	only their handles are shuffled around, so big objects are cheap to sift.
+*/
+
+///
+/// Creates a new heap capable of holding at least capacity number of
+/// data_type_size-sized objects with optional destructor
+/// \param capacity Minimum capacity request (0 is fine if you have no opinion)
+/// \param data_type_size Size of the object type to be stored in bytes
+/// \param compare the ordering, compare(x,y) < 0 iff x comes out before y
+/// \param destruct_func Optional destructor to be applied on destruct operations (NULL to disable)
+/// \return new heap pointer, NULL on error
+///
+dyn_heap_t *dyn_heap_create(const size_t capacity, const size_t data_type_size,
+							int (*const compare)(const void *, const void *), void (*destruct_func)(void *));
+
+///
+/// Heap destructor
+/// Applies destructor to all remaining elements
+/// \param dyn_heap The heap to destruct
+///
+void dyn_heap_destroy(dyn_heap_t *const dyn_heap);
+
+///
+/// Copies the given object into the heap, increasing container size by one
+/// \param dyn_heap the heap
+/// \param object the object to insert
+/// \param handle optional destination for the handle of the new object (NULL if not needed)
+/// \return bool representing success of the operation
+///
+bool dyn_heap_push(dyn_heap_t *const dyn_heap, const void *const object, size_t *const handle);
+
+///
+/// Returns a pointer to the minimum object
+/// Pointer stays valid until that object leaves the heap or the heap grows
+/// \param dyn_heap the heap
+/// \return Pointer to the minimum object (NULL on error/empty heap)
+///
+void *dyn_heap_peek(const dyn_heap_t *const dyn_heap);
+
+///
+/// Returns the handle of the minimum object
+/// \param dyn_heap the heap
+/// \param handle destination for the handle
+/// \return bool representing success of the operation (false on empty heap)
+///
+bool dyn_heap_peek_handle(const dyn_heap_t *const dyn_heap, size_t *const handle);
+
+///
+/// Removes and optionally destructs the minimum object, decreasing the container size by one
+/// \param dyn_heap the heap
+/// \return bool representing success of the operation
+///
+bool dyn_heap_pop(dyn_heap_t *const dyn_heap);
+
+///
+/// Removes the minimum object and places it in the desired location, decreasing container size
+/// Does not destruct since it was returned to the user
+/// \param dyn_heap the heap
+/// \param object destination for extracted object
+/// \return bool representing success of the operation
+///
+bool dyn_heap_extract(dyn_heap_t *const dyn_heap, void *const object);
+
+///
+/// Removes the object named by handle (wherever it is in the heap) and places it in the desired location
+/// Does not destruct since it was returned to the user
+/// \param dyn_heap the heap
+/// \param handle the handle given by push
+/// \param object destination for extracted object
+/// \return bool representing success of the operation (false if handle is stale)
+///
+bool dyn_heap_extract_handle(dyn_heap_t *const dyn_heap, const size_t handle, void *const object);
+
+///
+/// Replaces the object named by handle with one that compares less than or equal to it
+/// and moves it up to its new place
+/// \param dyn_heap the heap
+/// \param handle the handle given by push
+/// \param object the replacement object
+/// \return bool representing success of the operation (false if handle is stale or the key increased)
+///
+bool dyn_heap_decrease_key(dyn_heap_t *const dyn_heap, const size_t handle, const void *const object);
+
+///
+/// Returns a pointer to the object named by handle
+/// \param dyn_heap the heap
+/// \param handle the handle given by push
+/// \return pointer to the object, NULL on error or stale handle
+///
+void *dyn_heap_at(const dyn_heap_t *const dyn_heap, const size_t handle);
+
+///
+/// Removes and optionally destructs all heap elements
+/// \param dyn_heap the heap
+///
+void dyn_heap_clear(dyn_heap_t *const dyn_heap);
+
+///
+/// Tests if heap is empty
+/// \param dyn_heap the heap
+/// \return true if heap is empty (or NULL was passed), false otherwise
+///
+bool dyn_heap_empty(const dyn_heap_t *const dyn_heap);
+
+///
+/// Returns size of heap
+/// \param dyn_heap the heap
+/// \return the number of objects in the heap, 0 on error
+///
+size_t dyn_heap_size(const dyn_heap_t *const dyn_heap);
+
+///
+/// Returns the size of the object stored in the heap
+/// \param dyn_heap the heap
+/// \return the size of a stored object (bytes), 0 on error
+///
+size_t dyn_heap_data_size(const dyn_heap_t *const dyn_heap);
+
+#ifdef __cplusplus
+  }
+#endif
+
+#endif
@@ -0,0 +1,173 @@
+#ifndef DYN_RING_H
+#define DYN_RING_H
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "dyn_array.h"
+
+typedef struct dyn_ring dyn_ring_t;
+
+/*
+	Companion to dyn_array: a circular buffer (deque) of data_type_size-sized objects.
+
+	Unlike dyn_array, both ends are cheap. push/pop/extract at the front or the back
+	never move the other contents, they just walk the head or tail around the ring.
+	Only growing the capacity copies anything.
+
+	Destructor notes are the same as dyn_array:
+	the optional destructor is set at creation, NULL disables it,
+	pop triggers it and extract avoids it.
+*/
+
+///
+/// Creates a new ring capable of holding at least capacity number of
+/// data_type_size-sized objects with optional destructor
+/// \param capacity Minimum capacity request (0 is fine if you have no opinion)
+/// \param data_type_size Size of the object type to be stored in bytes
+/// \param destruct_func Optional destructor to be applied on destruct operations (NULL to disable)
+/// \return new ring pointer, NULL on error
+///
+dyn_ring_t *dyn_ring_create(const size_t capacity, const size_t data_type_size, void (*destruct_func)(void *));
+
+///
+/// Same as dyn_ring_create, with the ring and its contents placed by the given allocator
+/// \param capacity Minimum capacity request (0 is fine if you have no opinion)
+/// \param data_type_size Size of the object type to be stored in bytes
+/// \param destruct_func Optional destructor to be applied on destruct operations (NULL to disable)
+/// \param allocator the allocator, copied, NULL for the heap; its context must outlive the ring
+/// \return new ring pointer, NULL on error
+///
+dyn_ring_t *dyn_ring_create_with_allocator(const size_t capacity, const size_t data_type_size,
+										   void (*destruct_func)(void *), const dyn_allocator_t *const allocator);
+
+///
+/// Ring destructor
+/// Applies destructor to all remaining elements
+/// \param dyn_ring The ring to destruct
+///
+void dyn_ring_destroy(dyn_ring_t *const dyn_ring);
+
+
+
+
+///
+/// Returns a pointer to the object at the front of the ring
+/// \param dyn_ring the ring
+/// \return Pointer to front object (NULL on error/empty ring)
+///
+void *dyn_ring_front(const dyn_ring_t *const dyn_ring);
+
+///
+/// Copies the given object and places it at the front of the ring, increasing container size by one
+/// \param dyn_ring the ring
+/// \param object the object to insert
+/// \return bool representing success of the operation
+///
+bool dyn_ring_push_front(dyn_ring_t *const dyn_ring, const void *const object);
+
+///
+/// Removes and optionally destructs the object at the front of the ring, decreasing the container size by one
+/// \param dyn_ring the ring
+/// \return bool representing success of the operation
+///
+bool dyn_ring_pop_front(dyn_ring_t *const dyn_ring);
+
+///
+/// Removes the object in the front of the ring and places it in the desired location, decreasing container size
+/// Does not destruct since it was returned to the user
+/// \param dyn_ring the ring
+/// \param object destination for extracted object
+/// \return bool representing success of the operation
+///
+bool dyn_ring_extract_front(dyn_ring_t *const dyn_ring, void *const object);
+
+
+
+///
+/// Returns a pointer to the object at the back of the ring
+/// \param dyn_ring the ring
+/// \return Pointer to back object (NULL on error/empty ring)
+///
+void *dyn_ring_back(const dyn_ring_t *const dyn_ring);
+
+///
+/// Copies the given object and places it at the back of the ring, increasing container size by one
+/// \param dyn_ring the ring
+/// \param object the object to insert
+/// \return bool representing success of the operation
+///
+bool dyn_ring_push_back(dyn_ring_t *const dyn_ring, const void *const object);
+
+///
+/// Removes and optionally destructs the object at the back of the ring
+/// \param dyn_ring the ring
+/// \return bool representing success of the operation
+///
+bool dyn_ring_pop_back(dyn_ring_t *const dyn_ring);
+
+///
+/// Removes the object in the back of the ring and places it in the desired location
+/// Does not destruct since it was returned to the user
+/// \param dyn_ring the ring
+/// \param object destination for extracted object
+/// \return bool representing success of the operation
+///
+bool dyn_ring_extract_back(dyn_ring_t *const dyn_ring, void *const object);
+
+
+///
+/// Returns a pointer to the desired object in the ring, counting from the front
+/// Pointer may be invalidated if the container increases in size
+/// \param dyn_ring the ring
+/// \param index the index of the object to retrieve
+/// \return pointer to the requested object, NULL on error
+///
+void *dyn_ring_at(const dyn_ring_t *const dyn_ring, const size_t index);
+
+///
+/// Removes and optionally destructs all ring elements
+/// \param dyn_ring the ring
+///
+void dyn_ring_clear(dyn_ring_t *const dyn_ring);
+
+///
+/// Tests if ring is empty
+/// \param dyn_ring the ring
+/// \return true if ring is empty (or NULL was passed), false otherwise
+///
+bool dyn_ring_empty(const dyn_ring_t *const dyn_ring);
+
+///
+/// Returns size of ring
+/// \param dyn_ring the ring
+/// \return the size of the ring, 0 on error
+///
+size_t dyn_ring_size(const dyn_ring_t *const dyn_ring);
+
+///
+/// Returns the current capacity of the ring
+/// \param dyn_ring the ring
+/// \return the capacity of the ring, 0 on error
+///
+size_t dyn_ring_capacity(const dyn_ring_t *const dyn_ring);
+
+///
+/// Returns the size of the object stored in the ring
+/// \param dyn_ring the ring
+/// \return the size of a stored object (bytes), 0 on error
+///
+size_t dyn_ring_data_size(const dyn_ring_t *const dyn_ring);
+
+#ifdef __cplusplus
+  }
+#endif
+
+#endif
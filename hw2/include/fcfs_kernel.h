@@ -0,0 +1,73 @@
+#ifndef FCFS_KERNEL_H
+#define FCFS_KERNEL_H
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "pcb_columns.h"
+
+/*
+	Closed form FCFS.
+
+	FCFS dispatches in queue order, so every finish time follows from the one
+	before it: finish_i = max(arrival_i, finish_{i-1}) + burst_i. With B_i the
+	running sum of bursts that unrolls to
+
+		finish_i = B_i + max over j <= i of (arrival_j - B_{j-1})
+
+	which is a prefix sum followed by a prefix max, both of which vectorize.
+	They only pay with a native 64 bit max, which is AVX-512F. Narrower
+	vectors have to emulate it and end up slower than the scalar loop.
+	Everything is done in 64 bit integers, with the per lane totals carried
+	into 128 bits, so every kernel produces exactly the same totals and no
+	trace can overflow them.
+*/
+
+	typedef enum
+	{
+		FCFS_KERNEL_SCALAR,		// plain C, always available
+		FCFS_KERNEL_AVX512		// eight 64 bit lanes and a native 64 bit max
+	}
+	FcfsKernel_t;
+
+	typedef struct
+	{
+		ScheduleTotal_t total_waiting_time;		// sum of dispatch - arrival
+		ScheduleTotal_t total_turnaround_time;	// sum of finish - arrival
+		uint64_t total_run_time;				// when the last job finishes
+	}
+	FcfsTotals_t;
+
+	// \return AVX-512 when this CPU supports it, checked at runtime, else scalar
+	FcfsKernel_t fcfs_kernel_best(void);
+
+	// \param kernel the kernel to check
+	// \return true if kernel was compiled in and this CPU can run it
+	bool fcfs_kernel_supported(FcfsKernel_t kernel);
+
+	// Computes the FCFS totals for the PCBs in columns, in column order
+	// \param kernel which implementation to use, see fcfs_kernel_best
+	// \param columns the PCBs to schedule, not modified
+	// \param totals filled in with the totals
+	// \return true if function ran successful else false for an error (including an unsupported kernel)
+	bool fcfs_kernel_run(FcfsKernel_t kernel, const PcbColumns_t *columns, FcfsTotals_t *totals);
+
+	// Carries on the FCFS schedule in totals with count more jobs, so a trace can be fed a block at a time
+	// Start a schedule with every total at 0, then the blocks in order give exactly the totals of one run
+	// \param kernel which implementation to use, see fcfs_kernel_best
+	// \param burst the bursts of the next count jobs, in dispatch order
+	// \param arrival the arrivals of the same jobs
+	// \param count number of jobs, 0 leaves totals as they are
+	// \param totals the schedule so far, total_run_time is when the CPU frees up, added to
+	// \return true if function ran successful else false for an error (including an unsupported kernel)
+	bool fcfs_kernel_resume(FcfsKernel_t kernel, const uint32_t *burst, const uint32_t *arrival, size_t count,
+							FcfsTotals_t *totals);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
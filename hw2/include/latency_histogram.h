@@ -0,0 +1,53 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+	Streaming quantile sketch for 64 bit times, in the style of an HDR
+	histogram.
+
+	Values below 256 get a bucket each. Above that every power of two is
+	split into 128 equal buckets, so a reported quantile is never more than
+	1/128 (under 0.8%) above the true value. The bucket array has a fixed
+	size (about 58KB), however many values are recorded.
+*/
+
+	typedef struct latency_histogram latency_histogram_t;
+
+	// \return a new empty histogram if successful else NULL for an error
+	latency_histogram_t *latency_histogram_create(void);
+
+	// Frees the histogram
+	// \param histogram the histogram to free, may be NULL
+	void latency_histogram_destroy(latency_histogram_t *histogram);
+
+	// Adds one value
+	// \param histogram the histogram to add to
+	// \param value the value to count
+	void latency_histogram_record(latency_histogram_t *histogram, uint64_t value);
+
+	// \param histogram the histogram to read
+	// \return how many values have been recorded
+	uint64_t latency_histogram_count(const latency_histogram_t *histogram);
+
+	// \param histogram the histogram to read
+	// \return the largest value recorded, exact, 0 if there are none
+	uint64_t latency_histogram_max(const latency_histogram_t *histogram);
+
+	// The value at quantile q, the smallest bucket that covers ceil(q * count) values
+	// Reported as the top of that bucket, capped at the true maximum
+	// \param histogram the histogram to read
+	// \param quantile between 0 and 1, e.g. 0.99 for p99
+	// \return the value at the quantile, 0 if nothing has been recorded
+	uint64_t latency_histogram_quantile(const latency_histogram_t *histogram, double quantile);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,48 @@
+#ifndef PCB_COLUMNS_H
+#define PCB_COLUMNS_H
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "dyn_array.h"
+#include "processing_scheduling.h"
+
+/*
+	Structure-of-arrays view of a ready queue.
+
+	ProcessControlBlock_t packs three uint32_t and a bool into 16 bytes, so a
+	pass that only needs burst and arrival still pulls priority and the
+	started flag through the cache. Here every field gets its own array, 64
+	byte aligned, so a pass over one field reads only that field and can
+	load it straight into vector registers, which is what the FCFS kernels
+	(fcfs_kernel.h) run on.
+*/
+
+	typedef struct
+	{
+		uint32_t *burst;		// remaining_burst_time of each PCB
+		uint32_t *priority;
+		uint32_t *arrival;
+		bool *started;
+		size_t size;			// number of PCBs, the length of every array
+	}
+	PcbColumns_t;
+
+	// Splits a ready queue into one array per field, back of the queue first (dispatch order)
+	// \param ready_queue a dyn_array of type ProcessControlBlock_t, not modified
+	// \return the columns if successful else NULL for an error (including an empty queue)
+	PcbColumns_t *pcb_columns_from_queue(const dyn_array_t *ready_queue);
+
+	// Frees the columns
+	// \param columns the columns to free, may be NULL
+	void pcb_columns_destroy(PcbColumns_t *columns);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,66 @@
+#ifndef PCB_GENERATOR_H
+#define PCB_GENERATOR_H
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+	typedef enum
+	{
+		ARRIVALS_EXPONENTIAL,	// Poisson process, exponential gaps with mean arrival_mean
+		ARRIVALS_UNIFORM,		// gaps uniform in [0, 2 * arrival_mean]
+		ARRIVALS_STORM			// quiet stretches broken by storms of storm_size jobs on average
+	}
+	ArrivalDistribution_t;
+
+	typedef enum
+	{
+		BURSTS_UNIFORM,			// uniform in [1, 2 * burst_mean - 1]
+		BURSTS_EXPONENTIAL,		// exponential with mean burst_mean
+		BURSTS_PARETO			// heavy tailed Pareto with shape pareto_alpha and mean burst_mean
+	}
+	BurstDistribution_t;
+
+	typedef struct
+	{
+		uint32_t count;						// how many PCBs to write
+		uint64_t seed;						// same seed and settings give the same file
+		ArrivalDistribution_t arrivals;
+		double arrival_mean;				// mean time between arrivals
+		uint32_t storm_size;				// mean number of jobs per storm (ARRIVALS_STORM only)
+		BurstDistribution_t bursts;
+		double burst_mean;					// mean burst time
+		double pareto_alpha;				// Pareto shape, must be above 1 (BURSTS_PARETO only)
+		uint32_t priority_levels;			// priorities are uniform in [0, priority_levels - 1]
+	}
+	PcbGeneratorConfig_t;
+
+	// Fills config with the defaults: exponential arrivals every 25, uniform bursts of mean 20, 32 priorities
+	// That keeps the CPU about 80% busy, and 10^8 records still fit arrivals in 32 bits
+	// \param config the config to fill
+	// \param count how many PCBs to write
+	// \param seed the random seed
+	void pcb_generator_defaults(PcbGeneratorConfig_t *config, uint32_t count, uint64_t seed);
+
+	// Writes a PCB file in the format load_process_control_blocks reads:
+	// a uint32_t count followed by count (burst, priority, arrival) uint32_t triples, in arrival order
+	// Records are generated and written in fixed size blocks, so memory use does not depend on count
+	// \param output the stream to write to
+	// \param config what to generate
+	// \return true if function ran successful else false for an error (bad config, write error, arrival overflow)
+	bool pcb_generate(FILE *output, const PcbGeneratorConfig_t *config);
+
+	// Same as pcb_generate, writing to the file at path
+	// \param path the file to create or overwrite
+	// \param config what to generate
+	// \return true if function ran successful else false for an error
+	bool pcb_generate_file(const char *path, const PcbGeneratorConfig_t *config);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -9,6 +9,7 @@
 #include <stdint.h>
 
 #include "dyn_array.h"
+#include "schedule_timeline.h"
 
 	typedef struct
 	{
@@ -27,6 +28,103 @@
 	} 
 	ScheduleResult_t;
 
+	// Exact sum of one per-process time over a run
+	// 128 bits, so not even 2^64 processes of 2^64 ticks each can overflow it
+	__extension__ typedef unsigned __int128 ScheduleTotal_t;
+
+	// Tail of one per-process time, taken from a streaming histogram
+	// Exact below 256, otherwise at most 1/128 above the true value (max is always exact)
+	typedef struct
+	{
+		uint64_t p50;
+		uint64_t p90;
+		uint64_t p99;
+		uint64_t max;
+	}
+	ScheduleQuantiles_t;
+
+	// Extended stats for a run, in memory that does not grow with the number of processes
+	typedef struct
+	{
+		// ready is turnaround - burst, every tick spent ready but not running, while ScheduleResult_t's
+		// average_waiting_time only counts up to the first dispatch, which is response here
+		ScheduleQuantiles_t ready;			// turnaround - burst, all the time spent ready but not running
+		ScheduleQuantiles_t turnaround;		// completion - arrival
+		ScheduleQuantiles_t response;		// first dispatch - arrival, the time average_waiting_time averages
+		float cpu_utilisation;				// fraction of total_run_time the CPU was busy, 0 to 1
+
+		// the exact totals behind the averages, and the averages rounded once to double
+		uint64_t num_processes;
+		ScheduleTotal_t total_ready_time;
+		ScheduleTotal_t total_turnaround_time;
+		ScheduleTotal_t total_response_time;
+		double average_ready_time;
+		double average_turnaround_time;
+		double average_response_time;
+	}
+	ScheduleStats_t;
+
+	// Optional extra outputs of a run, any field may be NULL
+	typedef struct
+	{
+		const ScheduleTimeline_t *timeline;	// receives every slice the CPU runs, in dispatch order
+		ScheduleStats_t *stats;				// filled in with the extended stats
+	}
+	ScheduleOutputs_t;
+
+	// How the priority scheduler runs, lower priority values go first
+	typedef struct
+	{
+		bool preemptive;			// an arrival that outranks the running job takes the CPU from it
+		uint64_t aging_interval;	// a job gains one priority level per this much time since it last joined the
+									// ready set (arrived or was preempted), 0 for no aging
+	}
+	PriorityConfig_t;
+
+	// Read-only window onto PCBs someone else owns, e.g. one loaded trace shared by many runs
+	// PCB i starts at base + i * stride, and like a ready_queue the last one is the back of the queue
+	typedef struct
+	{
+		const void *base;
+		size_t count;
+		size_t stride;		// bytes from one PCB to the next, at least sizeof(ProcessControlBlock_t)
+	}
+	PcbView_t;
+
+	// Most levels a multilevel feedback queue can have
+	#define MLFQ_MAX_LEVELS 64
+
+	// Shape of a multilevel feedback queue
+	typedef struct
+	{
+		size_t num_levels;			// how many levels, 1 to MLFQ_MAX_LEVELS
+		const size_t *quanta;		// the quantum of each level, top level first, all positive
+		uint64_t boost_interval;	// every waiting job goes back to the top level this often, 0 for never
+	}
+	MlfqConfig_t;
+
+	// How a multi-core run hands jobs to its cores
+	typedef enum
+	{
+		SMP_GLOBAL_QUEUE,		// every core takes its next job from one shared ready queue
+		SMP_PER_CORE_QUEUES		// each arrival goes to core pid % cores, an idle core with nothing queued steals
+								// from the core with the most jobs waiting
+	}
+	SmpQueueing_t;
+
+	// What one core of a multi-core run did
+	typedef struct
+	{
+		uint64_t busy_time;		// time spent running jobs
+		float utilisation;		// busy_time / total_run_time, 0 to 1
+		size_t slices;			// how many slices it ran
+		size_t steals;			// jobs it took from another core's queue, always 0 with a global queue
+	}
+	SmpCoreStats_t;
+
+	// Cursor over a PCB file that reads the records a block at a time
+	typedef struct pcb_stream pcb_stream_t;
+
 	// Reads the PCB values from the binary file into ProcessControlBlock_t
 	// for N number of PCB entries stored in the file
 	// \param input_file the file containing the PCB burst times
@@ -49,6 +147,7 @@
 	bool shortest_job_first(dyn_array_t *ready_queue, ScheduleResult_t *result);
 
 	// Runs the non-preemptive Priority algorithm over the incoming ready_queue
+	// The lowest priority value runs first, ties go to the earliest arrival
 	// \param ready queue a dyn_array of type ProcessControlBlock_t that contain be up to N elements
 	// \param result used for shortest job first stat tracking \ref ScheduleResult_t
 	// \return true if function ran successful else false for an error
@@ -70,6 +169,123 @@
 	// There is no guarantee that the passed dyn_array_t will be the result of your implementation of load_process_control_blocks
 	bool shortest_remaining_time_first(dyn_array_t *ready_queue, ScheduleResult_t *result);
 
+	// Runs the Multilevel Feedback Queue Process Scheduling algorithm over the incoming ready_queue
+	// Jobs arrive at the top level, the highest level with jobs waiting runs round robin with its own quantum,
+	// a job that uses its whole quantum drops a level, and the boost lifts every waiting job back to the top
+	// An arrival takes the CPU from a job below the top level, which goes back first in its level without dropping
+	// \param ready queue a dyn_array of type ProcessControlBlock_t that contain be up to N elements
+	// \param result used for multilevel feedback queue stat tracking \ref ScheduleResult_t
+	// \param config the levels, their quanta and the boost interval \ref MlfqConfig_t
+	// \return true if function ran successful else false for an error
+	bool multilevel_feedback_queue(dyn_array_t *ready_queue, ScheduleResult_t *result, const MlfqConfig_t *config);
+
+	// Opens a PCB file for streaming, checking the header the same way load_process_control_blocks does
+	// Only one fixed size block of records is held in memory, however long the file is
+	// \param input_file the file containing the PCB burst times
+	// \return a cursor positioned at the first PCB if function ran successful else NULL for an error
+	pcb_stream_t *pcb_stream_open(const char *input_file);
+
+	// Reads the next PCB from the stream
+	// \param stream the cursor to advance
+	// \param pcb filled in with the PCB, started is false
+	// \return true if a PCB was read, false at the end of the file or for an error (see pcb_stream_failed)
+	bool pcb_stream_next(pcb_stream_t *stream, ProcessControlBlock_t *pcb);
+
+	// \param stream the cursor to check
+	// \return true if a read failed, e.g. the file was shorter than its header said
+	bool pcb_stream_failed(const pcb_stream_t *stream);
+
+	// Closes the file and frees the cursor
+	// \param stream the cursor to close, may be NULL
+	void pcb_stream_close(pcb_stream_t *stream);
+
+	// Streaming versions of the schedulers above, for traces too large to load
+	// PCBs are pulled from stream as the simulated clock reaches their arrival, so memory use is
+	// proportional to the number of processes waiting at once rather than to the length of the file
+	// The stream is consumed by the run, pids count up from the first record in the file
+	// FCFS takes the file in any order like first_come_first_serve does, the other policies need it in
+	// arrival order (as generate_pcbs writes it) and fail if an arrival goes backwards
+	// \param stream a freshly opened cursor, still owned by the caller
+	// \param result the stats for the run \ref ScheduleResult_t
+	// \param outputs optional timeline and extended stats \ref ScheduleOutputs_t, NULL for neither
+	// \return true if function ran successful else false for an error
+	bool first_come_first_serve_stream(pcb_stream_t *stream, ScheduleResult_t *result, const ScheduleOutputs_t *outputs);
+	bool shortest_job_first_stream(pcb_stream_t *stream, ScheduleResult_t *result, const ScheduleOutputs_t *outputs);
+	bool priority_stream(pcb_stream_t *stream, ScheduleResult_t *result, const PriorityConfig_t *config,
+						 const ScheduleOutputs_t *outputs);
+	bool round_robin_stream(pcb_stream_t *stream, ScheduleResult_t *result, size_t quantum,
+							const ScheduleOutputs_t *outputs);
+	bool shortest_remaining_time_first_stream(pcb_stream_t *stream, ScheduleResult_t *result,
+											  const ScheduleOutputs_t *outputs);
+	bool multilevel_feedback_queue_stream(pcb_stream_t *stream, ScheduleResult_t *result, const MlfqConfig_t *config,
+										  const ScheduleOutputs_t *outputs);
+
+	// Versions of the schedulers above that also produce the optional outputs
+	// The results are the same as without them, timeline pids count up from the back of the queue
+	// \param ready queue a dyn_array of type ProcessControlBlock_t that contain be up to N elements
+	// \param result the stats for the run \ref ScheduleResult_t
+	// \param outputs optional timeline and extended stats \ref ScheduleOutputs_t, NULL for neither
+	// \return true if function ran successful else false for an error (including a sink that refused a slice)
+	bool first_come_first_serve_detailed(dyn_array_t *ready_queue, ScheduleResult_t *result,
+										 const ScheduleOutputs_t *outputs);
+	bool shortest_job_first_detailed(dyn_array_t *ready_queue, ScheduleResult_t *result, const ScheduleOutputs_t *outputs);
+	bool priority_detailed(dyn_array_t *ready_queue, ScheduleResult_t *result, const PriorityConfig_t *config,
+						   const ScheduleOutputs_t *outputs);
+	bool round_robin_detailed(dyn_array_t *ready_queue, ScheduleResult_t *result, size_t quantum,
+							  const ScheduleOutputs_t *outputs);
+	bool shortest_remaining_time_first_detailed(dyn_array_t *ready_queue, ScheduleResult_t *result,
+												const ScheduleOutputs_t *outputs);
+	bool multilevel_feedback_queue_detailed(dyn_array_t *ready_queue, ScheduleResult_t *result,
+											const MlfqConfig_t *config, const ScheduleOutputs_t *outputs);
+
+	// Versions of the schedulers above that leave their input alone
+	// Only the view is read, whatever a run needs (sort order, ready sets, columns) lives in scratch it
+	// allocates and frees itself, so any number of runs, on any threads, can share one trace without copies
+	// The results are those of the consuming versions over the queue the view was taken from
+	// \param view the PCBs to schedule, at least one
+	// \param result the stats for the run \ref ScheduleResult_t
+	// \param outputs optional timeline and extended stats \ref ScheduleOutputs_t, NULL for neither
+	// \return true if function ran successful else false for an error
+	bool first_come_first_serve_view(const PcbView_t *view, ScheduleResult_t *result, const ScheduleOutputs_t *outputs);
+	bool shortest_job_first_view(const PcbView_t *view, ScheduleResult_t *result, const ScheduleOutputs_t *outputs);
+	bool priority_view(const PcbView_t *view, ScheduleResult_t *result, const PriorityConfig_t *config,
+					   const ScheduleOutputs_t *outputs);
+	bool round_robin_view(const PcbView_t *view, ScheduleResult_t *result, size_t quantum,
+						  const ScheduleOutputs_t *outputs);
+	bool shortest_remaining_time_first_view(const PcbView_t *view, ScheduleResult_t *result,
+											const ScheduleOutputs_t *outputs);
+	bool multilevel_feedback_queue_view(const PcbView_t *view, ScheduleResult_t *result, const MlfqConfig_t *config,
+										const ScheduleOutputs_t *outputs);
+
+	// Takes a view of every PCB in a ready queue, valid until the queue is changed
+	// \param view filled in with the view
+	// \param ready_queue a dyn_array of type ProcessControlBlock_t, not modified
+	// \return true if function ran successful else false for an error (including an empty queue)
+	bool pcb_view_from_queue(PcbView_t *view, const dyn_array_t *ready_queue);
+
+	// Multi-core versions of the schedulers above, every core runs the same policy
+	// Queue order, the quantum and preemption mean the same as on one core, with one core they give the same results
+	// Preemptive SRTF keeps the num_cores shortest jobs running, rechecking at every arrival, preemptive priority
+	// likewise keeps the num_cores highest priorities running
+	// Not supported across cores: priority with aging (priority_smp returns false for a nonzero aging_interval)
+	// and MLFQ, whose per-level quanta, boosts and arrival preemption the multi-core engine does not simulate
+	// \param ready queue a dyn_array of type ProcessControlBlock_t that contain be up to N elements
+	// \param result the aggregate stats for the run \ref ScheduleResult_t, total_run_time is when the last core finished
+	// \param num_cores how many cores to simulate, at least 1
+	// \param queueing a global queue or per-core queues \ref SmpQueueing_t
+	// \param cores optional array of num_cores filled in with what each core did, NULL to skip
+	// \return true if function ran successful else false for an error
+	bool first_come_first_serve_smp(dyn_array_t *ready_queue, ScheduleResult_t *result, size_t num_cores,
+									SmpQueueing_t queueing, SmpCoreStats_t *cores);
+	bool shortest_job_first_smp(dyn_array_t *ready_queue, ScheduleResult_t *result, size_t num_cores,
+								SmpQueueing_t queueing, SmpCoreStats_t *cores);
+	bool priority_smp(dyn_array_t *ready_queue, ScheduleResult_t *result, const PriorityConfig_t *config,
+					  size_t num_cores, SmpQueueing_t queueing, SmpCoreStats_t *cores);
+	bool round_robin_smp(dyn_array_t *ready_queue, ScheduleResult_t *result, size_t quantum, size_t num_cores,
+						 SmpQueueing_t queueing, SmpCoreStats_t *cores);
+	bool shortest_remaining_time_first_smp(dyn_array_t *ready_queue, ScheduleResult_t *result, size_t num_cores,
+										   SmpQueueing_t queueing, SmpCoreStats_t *cores);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,100 @@
+#ifndef SCHEDULE_BATCH_H
+#define SCHEDULE_BATCH_H
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "dyn_array.h"
+#include "processing_scheduling.h"
+
+	typedef enum
+	{
+		SCHEDULE_FCFS,
+		SCHEDULE_SJF,
+		SCHEDULE_PRIORITY,
+		SCHEDULE_RR,
+		SCHEDULE_SRTF
+	}
+	ScheduleAlgorithm_t;
+
+	typedef struct
+	{
+		ScheduleAlgorithm_t algorithm;	// which scheduler to run
+		size_t quantum;					// the quantum, only used by round robin
+		char name[24];					// label for output, e.g. "RR:4"
+	}
+	ScheduleRequest_t;
+
+	typedef struct
+	{
+		ScheduleRequest_t request;		// what was run
+		ScheduleResult_t result;		// its stats, only valid if success
+		bool success;					// if the scheduler ran successfully
+	}
+	ScheduleRun_t;
+
+	// Quantum RR runs with under "ALL" when no default quantum is given
+	#define SCHEDULE_ALL_QUANTUM 4
+
+	// Parses a batch specification into a list of requests
+	// "ALL" selects FCFS, SJF, P, RR and SRT; otherwise a comma separated list such as "FCFS,SJF,RR:4"
+	// \param spec the batch specification
+	// \param default_quantum quantum for RR entries without one, 0 if there is none (SCHEDULE_ALL_QUANTUM for "ALL")
+	// \return a dyn_array of ScheduleRequest_t if function ran successful else NULL for an error
+	dyn_array_t *schedule_batch_parse(const char *spec, size_t default_quantum);
+
+	// Runs one request over the ready queue
+	// \param ready_queue a dyn_array of type ProcessControlBlock_t, consumed like the scheduler itself
+	// \param request the scheduler to run
+	// \param result used for stat tracking \ref ScheduleResult_t
+	// \return true if function ran successful else false for an error
+	bool schedule_run(dyn_array_t *ready_queue, const ScheduleRequest_t *request, ScheduleResult_t *result);
+
+	// Runs one request over a view, leaving the PCBs behind it untouched
+	// \param view the PCBs to schedule \ref PcbView_t
+	// \param request the scheduler to run
+	// \param result used for stat tracking \ref ScheduleResult_t
+	// \return true if function ran successful else false for an error
+	bool schedule_run_view(const PcbView_t *view, const ScheduleRequest_t *request, ScheduleResult_t *result);
+
+	// Runs every request over one shared view of the ready queue, spread across a pool of worker threads
+	// \param ready_queue a dyn_array of type ProcessControlBlock_t, left untouched
+	// \param requests a dyn_array of type ScheduleRequest_t
+	// \param num_threads how many simulations may run at once, 0 for one per online core
+	// \return a dyn_array of ScheduleRun_t in request order if function ran successful else NULL for an error
+	dyn_array_t *schedule_batch_run(const dyn_array_t *ready_queue, const dyn_array_t *requests, size_t num_threads);
+
+	// Called for each finished run, in request order, as soon as it and every run before it are done
+	typedef void (*ScheduleRunCallback_t)(const ScheduleRun_t *run, void *context);
+
+	// Same as schedule_batch_run, but streams each run to on_run as it completes instead of only at the end
+	// \param on_run called once per run in request order, never from two threads at once (NULL to disable)
+	// \param context passed through to on_run
+	// \return a dyn_array of ScheduleRun_t in request order if function ran successful else NULL for an error
+	dyn_array_t *schedule_batch_run_streamed(const dyn_array_t *ready_queue, const dyn_array_t *requests,
+											 size_t num_threads, ScheduleRunCallback_t on_run, void *context);
+
+	// Parses a round robin quantum sweep "first:last[:step]" into one RR request per quantum
+	// \param range the sweep range, e.g. "1:64" or "1:64:4"
+	// \return a dyn_array of ScheduleRequest_t if function ran successful else NULL for an error
+	dyn_array_t *schedule_sweep_parse(const char *range);
+
+	// Runs a sweep over one arrival-sorted copy of the ready queue, streaming each run as it completes
+	// The input is sorted once here, so no run pays for its own sort
+	// \param ready_queue a dyn_array of type ProcessControlBlock_t, left untouched
+	// \param requests a dyn_array of type ScheduleRequest_t, typically from schedule_sweep_parse
+	// \param num_threads how many simulations may run at once, 0 for one per online core
+	// \param on_run called once per run in request order (NULL to disable)
+	// \param context passed through to on_run
+	// \return a dyn_array of ScheduleRun_t in request order if function ran successful else NULL for an error
+	dyn_array_t *schedule_sweep_run(const dyn_array_t *ready_queue, const dyn_array_t *requests,
+									size_t num_threads, ScheduleRunCallback_t on_run, void *context);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,105 @@
+#ifndef SCHEDULE_TIMELINE_H
+#define SCHEDULE_TIMELINE_H
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+	Gantt style record of a run: one slice per stretch of time a process
+	spent on the CPU, in dispatch order.
+
+	A scheduler hands each slice to a ScheduleTimeline_t as it happens, so
+	nothing is kept unless the sink keeps it. Two sinks are provided: a
+	caller provided array, and a writer for a compact binary file.
+
+	The file is the 4 byte magic "PCBT" followed by one record per slice,
+	each three LEB128 varints:
+		zigzag(pid - previous pid)
+		zigzag(start - previous end)
+		end - start
+	Round robin slices mostly move to a nearby pid and start where the last
+	one ended, so a typical slice takes three or four bytes.
+*/
+
+	typedef struct
+	{
+		size_t pid;			// position in the ready queue, back of the queue (or first record of the file) = 0
+		uint64_t start;		// when the process got the CPU
+		uint64_t end;		// when it gave it up, equal to start for a zero length burst
+	}
+	ScheduleSlice_t;
+
+	typedef struct
+	{
+		// receives every slice in dispatch order, returning false stops the run with an error
+		bool (*emit)(void *context, const ScheduleSlice_t *slice);
+		void *context;
+	}
+	ScheduleTimeline_t;
+
+	// Array sink state
+	typedef struct
+	{
+		ScheduleSlice_t *slices;
+		size_t capacity;
+		size_t size;		// slices recorded so far
+	}
+	ScheduleTimelineBuffer_t;
+
+	typedef struct schedule_timeline_writer schedule_timeline_writer_t;
+	typedef struct schedule_timeline_reader schedule_timeline_reader_t;
+
+	// Points timeline at a caller provided array, a run that produces more than capacity slices fails
+	// \param timeline the sink to set up
+	// \param buffer the state behind the sink, must outlive it
+	// \param slices where the slices go
+	// \param capacity how many slices fit
+	// \return true if function ran successful else false for an error
+	bool schedule_timeline_to_buffer(ScheduleTimeline_t *timeline, ScheduleTimelineBuffer_t *buffer,
+									 ScheduleSlice_t *slices, size_t capacity);
+
+	// Starts a timeline file on output, slices are encoded into a block and written a block at a time
+	// \param output the stream to write to, still owned by the caller
+	// \return the writer if successful else NULL for an error
+	schedule_timeline_writer_t *schedule_timeline_writer_create(FILE *output);
+
+	// Points timeline at a writer
+	// \param timeline the sink to set up
+	// \param writer where the slices go
+	// \return true if function ran successful else false for an error
+	bool schedule_timeline_to_writer(ScheduleTimeline_t *timeline, schedule_timeline_writer_t *writer);
+
+	// Writes out what is left in the block and frees the writer
+	// \param writer the writer to finish, may be NULL
+	// \return true if every slice reached output else false for an error
+	bool schedule_timeline_writer_finish(schedule_timeline_writer_t *writer);
+
+	// Opens a timeline file for reading, checking the magic
+	// \param input the stream to read from, still owned by the caller
+	// \return the reader if successful else NULL for an error
+	schedule_timeline_reader_t *schedule_timeline_reader_create(FILE *input);
+
+	// Decodes the next slice
+	// \param reader the reader to advance
+	// \param slice filled in with the slice
+	// \return true if a slice was read, false at the end of the file or for an error (see schedule_timeline_reader_failed)
+	bool schedule_timeline_reader_next(schedule_timeline_reader_t *reader, ScheduleSlice_t *slice);
+
+	// \param reader the reader to check
+	// \return true if the file ended part way through a slice or a read failed
+	bool schedule_timeline_reader_failed(const schedule_timeline_reader_t *reader);
+
+	// Frees the reader
+	// \param reader the reader to free, may be NULL
+	void schedule_timeline_reader_destroy(schedule_timeline_reader_t *reader);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,230 @@
+#ifndef SIM_ENGINE_H
+#define SIM_ENGINE_H
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "dyn_array.h"
+#include "latency_histogram.h"
+#include "processing_scheduling.h"
+#include "schedule_timeline.h"
+
+/*
+	Discrete-event simulation core shared by every scheduling policy.
+
+	Instead of stepping the virtual CPU one time unit at a time, the engine
+	jumps the clock straight to the next event: an arrival, a completion or
+	a quantum expiry. Runtime depends on the number of events, not on the
+	total burst time of the trace.
+
+	A policy only decides *which* job runs next. It does that through the
+	callbacks in SimPolicy_t, operating on its own ready set.
+
+	Jobs come from a SimFeed_t, which the engine pulls one job at a time as
+	the clock reaches its arrival. A feed can walk an array that is already
+	in memory or a cursor over a file, so the engine itself only ever holds
+	the jobs the policy has admitted.
+*/
+
+	typedef struct
+	{
+		ProcessControlBlock_t pcb;	// the process being simulated
+		size_t pid;					// position in the incoming ready queue (back of queue = 0)
+		uint32_t burst;				// the burst the job arrived with, remaining_burst_time counts down
+		uint32_t level;				// policy owned, e.g. the feedback level a job has sunk to, 0 on arrival
+	}
+	SimJob_t;
+
+	typedef struct
+	{
+		// moves a job that has just arrived into the ready set
+		bool (*admit)(void *ready_set, const SimJob_t *job);
+		// chooses the next job to run and copies it into job, false if the ready set is empty
+		bool (*select)(void *ready_set, SimJob_t *job);
+		// gives back a job whose slice ended before it completed
+		bool (*requeue)(void *ready_set, const SimJob_t *job);
+		// optional, called when the selected job completes (NULL if select already removed it)
+		bool (*retire)(void *ready_set, const SimJob_t *job);
+		void *ready_set;			// policy owned state handed to every callback
+		size_t quantum;				// longest slice a job may run for, 0 for run to completion
+		bool preempt_on_arrival;	// end the running slice whenever a new job arrives
+		// optional, the quantum for the job select just returned, overriding quantum (NULL to use quantum)
+		size_t (*quantum_of)(void *ready_set, const SimJob_t *job);
+		// optional, told the time before every select so the ready set can age or boost what it holds
+		bool (*age)(void *ready_set, uint64_t now);
+		// optional, whether an arrival ends the slice of the job select just returned, overriding
+		// preempt_on_arrival (NULL to use preempt_on_arrival)
+		bool (*preempt_on_arrival_of)(void *ready_set, const SimJob_t *job);
+	}
+	SimPolicy_t;
+
+	typedef struct
+	{
+		// the next job in feed order without consuming it, NULL once the feed is exhausted or has failed
+		const SimJob_t *(*peek)(void *source);
+		// consumes the job the last peek returned
+		void (*advance)(void *source);
+		void *source;				// feed owned state handed to every callback
+	}
+	SimFeed_t;
+
+	// Feed state for walking an in-memory array of SimJob_t
+	typedef struct
+	{
+		const SimJob_t *jobs;
+		size_t count;
+		size_t next;
+	}
+	SimJobCursor_t;
+
+	// Feed state for walking a PcbView_t without copying the PCBs behind it
+	typedef struct
+	{
+		PcbView_t view;
+		dyn_array_t *order;		// arrival << 32 | pid of every job in arrival order, NULL to walk pid order
+		size_t next;
+		SimJob_t job;			// the job peek last built
+	}
+	SimViewCursor_t;
+
+	// Turns the per-job events of a run into the optional outputs a caller asked for
+	// Only ever as large as its three histograms, however many jobs go through it
+	typedef struct
+	{
+		const ScheduleTimeline_t *timeline;
+		ScheduleStats_t *stats;
+		latency_histogram_t *ready;
+		latency_histogram_t *turnaround;
+		latency_histogram_t *response;
+	}
+	SimRecorder_t;
+
+	// Exact totals of a run, what every scheduler reports its results from
+	typedef struct
+	{
+		ScheduleTotal_t response_time;		// sum of first dispatch - arrival
+		ScheduleTotal_t turnaround_time;	// sum of completion - arrival
+		ScheduleTotal_t burst_time;			// sum of the bursts, all the time the CPU was busy
+		uint64_t num_processes;				// how many processes completed
+		uint64_t run_time;					// when the last process completed
+	}
+	SimTotals_t;
+
+	// Sets the allocator the calling thread's runs place their scratch with: copied jobs, sort keys and run queues
+	// Meant for an arena that is reset between runs, so a long batch stops going to malloc for scratch
+	// \param allocator the allocator, copied, NULL for the heap; its context must outlive every run while it is set
+	void sim_set_scratch_allocator(const dyn_allocator_t *allocator);
+
+	// \return the calling thread's scratch allocator, NULL for the heap
+	const dyn_allocator_t *sim_scratch_allocator(void);
+
+	// Drains ready_queue into a new dyn_array of SimJob_t, back of the queue first
+	// The array is scratch, placed by the scratch allocator
+	// \param ready_queue a dyn_array of type ProcessControlBlock_t, left empty on success
+	// \return a dyn_array of SimJob_t in dispatch order if successful else NULL for an error
+	dyn_array_t *sim_jobs_from_queue(dyn_array_t *ready_queue);
+
+	// Orders jobs by arrival time, ties broken by pid so the order is deterministic
+	// Jobs that are already in order are only scanned
+	// \param jobs a dyn_array of type SimJob_t
+	// \return true if function ran successful else false for an error
+	bool sim_sort_by_arrival(dyn_array_t *jobs);
+
+	// Reorders a ready queue by arrival time, earliest at the back, ties keep their queue order
+	// Schedulers that sort by arrival only scan a queue prepared this way, so it can be shared by many runs
+	// \param ready_queue a dyn_array of type ProcessControlBlock_t
+	// \return true if function ran successful else false for an error
+	bool sim_queue_sort_by_arrival(dyn_array_t *ready_queue);
+
+	// Divides an exact total by a count with a single rounding, to the nearest double
+	// \param total the sum to average
+	// \param count how many values went into it, 0 gives 0
+	// \return total / count
+	double sim_exact_average(ScheduleTotal_t total, uint64_t count);
+
+	// Fills in result from exact totals, the way every scheduler reports them
+	// \param result the stats to fill in \ref ScheduleResult_t
+	// \param totals the totals of the run, at least one process
+	void sim_result_from_totals(ScheduleResult_t *result, const SimTotals_t *totals);
+
+	// Sets up recorder for outputs, allocating histograms only if stats were asked for
+	// \param recorder the recorder to set up
+	// \param outputs what to record, may be NULL
+	// \return true if function ran successful else false for an error
+	bool sim_recorder_init(SimRecorder_t *recorder, const ScheduleOutputs_t *outputs);
+
+	// \param recorder the recorder to check
+	// \return true if the recorder wants any events at all, so a run can skip them cheaply
+	static inline bool sim_recorder_active(const SimRecorder_t *recorder)
+	{
+		return recorder->timeline != NULL || recorder->stats != NULL;
+	}
+
+	// Records one stretch of time a job spent on the CPU
+	// \param recorder where to record it
+	// \param job the job that ran, pcb.started clear on its first slice
+	// \param start when the slice began
+	// \param end when it ended
+	// \return true if function ran successful else false for an error (the timeline refused the slice)
+	bool sim_recorder_slice(SimRecorder_t *recorder, const SimJob_t *job, uint64_t start, uint64_t end);
+
+	// Records a job finishing
+	// \param recorder where to record it
+	// \param job the job that finished
+	// \param completion when it finished
+	void sim_recorder_complete(SimRecorder_t *recorder, const SimJob_t *job, uint64_t completion);
+
+	// Fills in the stats if they were asked for and frees the histograms
+	// \param recorder the recorder to finish, also called after a failed run to free it
+	// \param totals the totals of the run, NULL after a failed run
+	void sim_recorder_finish(SimRecorder_t *recorder, const SimTotals_t *totals);
+
+	// Sets up feed to hand out the jobs of an array in order
+	// \param feed the feed to fill in
+	// \param cursor the state behind feed, must outlive it
+	// \param jobs a dyn_array of type SimJob_t, not modified
+	// \return true if function ran successful else false for an error
+	bool sim_feed_from_jobs(SimFeed_t *feed, SimJobCursor_t *cursor, const dyn_array_t *jobs);
+
+	// Sets up feed to hand out the PCBs of a view as jobs, pids counting up from the back like sim_jobs_from_queue
+	// In arrival order (ties by pid) when by_arrival is set, otherwise in pid order
+	// Scratch is only allocated for a view that is out of arrival order, 8 bytes a job
+	// \param feed the feed to fill in
+	// \param cursor the state behind feed, must outlive it, released with sim_view_cursor_release
+	// \param view the PCBs, not modified, must outlive feed
+	// \param by_arrival hand jobs out by arrival instead of by pid
+	// \return true if function ran successful else false for an error
+	bool sim_feed_from_view(SimFeed_t *feed, SimViewCursor_t *cursor, const PcbView_t *view, bool by_arrival);
+
+	// Frees any scratch behind a view cursor
+	// \param cursor the cursor to release
+	void sim_view_cursor_release(SimViewCursor_t *cursor);
+
+	// Runs the event loop over the jobs a feed hands out and fills in result
+	// Jobs are admitted strictly in feed order, once the clock reaches their arrival
+	// A feed that stops early looks exhausted to the engine, so the caller checks the feed for errors
+	// \param feed where jobs come from
+	// \param policy the policy callbacks and slicing rules
+	// \param outputs optional timeline and extended stats, NULL to record nothing
+	// \param result the stats for the run \ref ScheduleResult_t
+	// \return true if function ran successful else false for an error (including a sink that refused a slice)
+	bool sim_run_feed(const SimFeed_t *feed, const SimPolicy_t *policy, const ScheduleOutputs_t *outputs,
+					  ScheduleResult_t *result);
+
+	// Runs the event loop over jobs using the given policy and fills in result
+	// Jobs are admitted strictly in the order they appear in jobs, once the clock reaches their arrival
+	// \param jobs a dyn_array of type SimJob_t, not modified
+	// \param policy the policy callbacks and slicing rules
+	// \param result the stats for the run \ref ScheduleResult_t
+	// \return true if function ran successful else false for an error
+	bool sim_run(const dyn_array_t *jobs, const SimPolicy_t *policy, ScheduleResult_t *result);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,44 @@
+#ifndef SMP_ENGINE_H
+#define SMP_ENGINE_H
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "processing_scheduling.h"
+#include "sim_engine.h"
+
+/*
+	Multi-core counterpart of the simulation core in sim_engine.h.
+
+	The same SimFeed_t and SimPolicy_t callbacks drive it, so any policy
+	whose select removes the job it picks can run on many cores. The clock
+	still jumps from event to event: a min-heap keyed on when each busy
+	core's slice ends gives the next one in O(log cores), so a run costs
+	O(events log cores) however long the bursts are.
+
+	With one ready set every core shares it. With one per core, arrivals
+	are spread over them by pid, and a core that runs dry steals the next
+	job from whichever core has the most waiting.
+*/
+
+	// Runs the event loop over the jobs a feed hands out on num_cores cores and fills in result
+	// Jobs are admitted in feed order once the clock reaches their arrival, like sim_run_feed
+	// Slices that end at the same time are put back in core order, after that time's arrivals
+	// \param feed where jobs come from
+	// \param policies the ready sets, one shared by every core or one per core, all with the same quantum and preemption
+	// \param num_queues how many policies there are, 1 or num_cores
+	// \param num_cores how many cores to simulate, at least 1
+	// \param cores optional array of num_cores filled in with what each core did, NULL to skip
+	// \param result the aggregate stats for the run \ref ScheduleResult_t
+	// \return true if function ran successful else false for an error
+	bool smp_run_feed(const SimFeed_t *feed, const SimPolicy_t *policies, size_t num_queues, size_t num_cores,
+					  SmpCoreStats_t *cores, ScheduleResult_t *result);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -1,27 +1,294 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "dyn_array.h"
 #include "processing_scheduling.h"
+#include "schedule_batch.h"
 
 #define FCFS "FCFS"
+#define MLFQ "MLFQ"
 #define P "P"
+#define PP "PP"
 #define RR "RR"
 #define SJF "SJF"
 #define SRT "SRT"
 
+#define ALL "ALL"
+
+// Runs several algorithms over one load of the PCB file and prints a comparison table
+// spec is "ALL" or a list such as "FCFS,SJF,RR:4", quantum_arg is the optional quantum for plain RR entries
+static int run_batch(const char* pcb_file, const char* spec, const char* quantum_arg)
+{
+	size_t default_quantum = 0;
+	if(quantum_arg != NULL && (sscanf(quantum_arg, "%zu", &default_quantum) != 1 || default_quantum == 0))
+	{
+		fprintf(stderr, "Error: quantum must be a positive integer.\n");
+		return EXIT_FAILURE;
+	}
+
+	dyn_array_t* requests = schedule_batch_parse(spec, default_quantum);
+	if(requests == NULL)
+	{
+		fprintf(stderr, "Error: invalid algorithm list '%s'\n", spec);
+		fprintf(stderr, "Use ALL [quantum] (RR defaults to %d), or a comma separated list of FCFS, SJF, P, RR[:quantum], SRT"
+						" with a quantum for any plain RR\n", SCHEDULE_ALL_QUANTUM);
+		return EXIT_FAILURE;
+	}
+
+	// load the process control blocks once, every algorithm reads the same copy
+	dyn_array_t* ready_queue = load_process_control_blocks(pcb_file);
+	if(ready_queue == NULL)
+	{
+		fprintf(stderr, "Error: failed to load PCBs from file '%s'\n", pcb_file);
+		dyn_array_destroy(requests);
+		return EXIT_FAILURE;
+	}
+
+	dyn_array_t* runs = schedule_batch_run(ready_queue, requests, 0);
+	dyn_array_destroy(ready_queue);
+	dyn_array_destroy(requests);
+	if(runs == NULL)
+	{
+		fprintf(stderr, "Error: batch run failed.\n");
+		return EXIT_FAILURE;
+	}
+
+	int status = EXIT_SUCCESS;
+	printf("%-12s %20s %23s %15s\n", "Algorithm", "Average Waiting Time", "Average Turnaround Time", "Total Run Time");
+	for(size_t i = 0; i < dyn_array_size(runs); i++)
+	{
+		const ScheduleRun_t* run = (const ScheduleRun_t*)dyn_array_at(runs, i);
+		if(!run->success)
+		{
+			printf("%-12s %20s\n", run->request.name, "failed");
+			status = EXIT_FAILURE;
+			continue;
+		}
+		printf("%-12s %20.2f %23.2f %15lu\n", run->request.name, run->result.average_waiting_time,
+			   run->result.average_turnaround_time, run->result.total_run_time);
+	}
+
+	dyn_array_destroy(runs);
+	return status;
+}
+
+// Prints one sweep row, called in quantum order as soon as each run finishes
+static void print_sweep_row(const ScheduleRun_t* run, void* context)
+{
+	(void)context;
+	if(run->success)
+		printf("%-12zu %20.2f %23.2f %15lu\n", run->request.quantum, run->result.average_waiting_time,
+			   run->result.average_turnaround_time, run->result.total_run_time);
+	else
+		printf("%-12zu %20s\n", run->request.quantum, "failed");
+	// stream each row out instead of letting stdio buffer the whole table
+	fflush(stdout);
+}
+
+// Runs round robin once per quantum in range ("first:last[:step]") over one load of the PCB file
+static int run_sweep(const char* pcb_file, const char* range)
+{
+	dyn_array_t* requests = schedule_sweep_parse(range);
+	if(requests == NULL)
+	{
+		fprintf(stderr, "Error: invalid quantum range '%s', expected first:last[:step]\n", range);
+		return EXIT_FAILURE;
+	}
+
+	dyn_array_t* ready_queue = load_process_control_blocks(pcb_file);
+	if(ready_queue == NULL)
+	{
+		fprintf(stderr, "Error: failed to load PCBs from file '%s'\n", pcb_file);
+		dyn_array_destroy(requests);
+		return EXIT_FAILURE;
+	}
+
+	printf("%-12s %20s %23s %15s\n", "Quantum", "Average Waiting Time", "Average Turnaround Time", "Total Run Time");
+	fflush(stdout);
+	dyn_array_t* runs = schedule_sweep_run(ready_queue, requests, 0, print_sweep_row, NULL);
+	dyn_array_destroy(ready_queue);
+	dyn_array_destroy(requests);
+	if(runs == NULL)
+	{
+		fprintf(stderr, "Error: quantum sweep failed.\n");
+		return EXIT_FAILURE;
+	}
+
+	int status = EXIT_SUCCESS;
+	for(size_t i = 0; i < dyn_array_size(runs); i++)
+	{
+		if(!((const ScheduleRun_t*)dyn_array_at(runs, i))->success)
+			status = EXIT_FAILURE;
+	}
+	dyn_array_destroy(runs);
+	return status;
+}
+
+// Prints one per-process time, its exact mean next to its tail
+static void print_stats_row(const char* name, double mean, const ScheduleQuantiles_t* quantiles)
+{
+	printf("%-32s %12.2f %10llu %10llu %10llu %10llu\n", name, mean, (unsigned long long)quantiles->p50,
+		   (unsigned long long)quantiles->p90, (unsigned long long)quantiles->p99, (unsigned long long)quantiles->max);
+}
+
+// Prints the tail of every per-process time after the averages
+// the Average Waiting Time above is the response mean, time ready also counts every wait after the first dispatch
+static void print_stats(const ScheduleStats_t* stats)
+{
+	printf("%-32s %12s %10s %10s %10s %10s\n", "", "mean", "p50", "p90", "p99", "max");
+	print_stats_row("Response (first dispatch)", stats->average_response_time, &stats->response);
+	print_stats_row("Time ready (turnaround - burst)", stats->average_ready_time, &stats->ready);
+	print_stats_row("Turnaround", stats->average_turnaround_time, &stats->turnaround);
+	printf("CPU Utilisation: %.2f%%\n", 100.0 * stats->cpu_utilisation);
+}
+
+// Reads the optional aging interval of P and PP, 0 when there is none
+static bool parse_aging(const char* aging_arg, uint64_t* aging_interval)
+{
+	unsigned long long aging = 0;
+	if(aging_arg != NULL && (*aging_arg == '-' || sscanf(aging_arg, "%llu", &aging) != 1))
+		return false;
+	*aging_interval = aging;
+	return true;
+}
+
+// Reads an MLFQ shape from "quantum,quantum,..." (top level first) and an optional boost interval
+// quanta must have room for MLFQ_MAX_LEVELS entries, config points into it
+static bool parse_mlfq(const char* quanta_arg, const char* boost_arg, size_t* quanta, MlfqConfig_t* config)
+{
+	if(quanta_arg == NULL)
+		return false;
+
+	config->num_levels     = 0;
+	config->quanta         = quanta;
+	config->boost_interval = 0;
+	const char* token = quanta_arg;
+	for(;;)
+	{
+		int consumed = 0;
+		if(config->num_levels == MLFQ_MAX_LEVELS || *token == '-'
+		   || sscanf(token, "%zu%n", &quanta[config->num_levels], &consumed) != 1
+		   || quanta[config->num_levels] == 0)
+			return false;
+		config->num_levels++;
+		token += consumed;
+		if(*token == '\0')
+			break;
+		if(*token != ',')
+			return false;
+		token++;
+	}
+
+	unsigned long long boost = 0;
+	if(boost_arg != NULL && (*boost_arg == '-' || sscanf(boost_arg, "%llu", &boost) != 1))
+		return false;
+	config->boost_interval = boost;
+	return true;
+}
+
+// Runs one algorithm over the PCB file without loading it, for traces that do not fit in memory
+static int run_stream(const char* pcb_file, const char* algorithm, const char* quantum_arg, const char* boost_arg)
+{
+	size_t quantum = 0;
+	if(strcmp(algorithm, RR) == 0 && (quantum_arg == NULL || sscanf(quantum_arg, "%zu", &quantum) != 1 || quantum == 0))
+	{
+		fprintf(stderr, "Error: Round Robin requires a positive quantum value.\n");
+		return EXIT_FAILURE;
+	}
+	PriorityConfig_t priority_config = { strcmp(algorithm, PP) == 0, 0 };
+	if((strcmp(algorithm, P) == 0 || strcmp(algorithm, PP) == 0)
+	   && !parse_aging(quantum_arg, &priority_config.aging_interval))
+	{
+		fprintf(stderr, "Error: the aging interval must be a non-negative integer.\n");
+		return EXIT_FAILURE;
+	}
+	size_t quanta[MLFQ_MAX_LEVELS];
+	MlfqConfig_t mlfq;
+	if(strcmp(algorithm, MLFQ) == 0 && !parse_mlfq(quantum_arg, boost_arg, quanta, &mlfq))
+	{
+		fprintf(stderr, "Error: MLFQ requires positive quanta such as 8,16,32 and an optional boost interval.\n");
+		return EXIT_FAILURE;
+	}
+
+	pcb_stream_t* stream = pcb_stream_open(pcb_file);
+	if(stream == NULL)
+	{
+		fprintf(stderr, "Error: failed to open PCB file '%s'\n", pcb_file);
+		return EXIT_FAILURE;
+	}
+
+	ScheduleResult_t result;
+	ScheduleStats_t stats;
+	ScheduleOutputs_t outputs = { NULL, &stats };
+	bool success = false;
+	if(strcmp(algorithm, FCFS) == 0)
+		success = first_come_first_serve_stream(stream, &result, &outputs);
+	else if(strcmp(algorithm, SJF) == 0)
+		success = shortest_job_first_stream(stream, &result, &outputs);
+	else if(strcmp(algorithm, RR) == 0)
+		success = round_robin_stream(stream, &result, quantum, &outputs);
+	else if(strcmp(algorithm, SRT) == 0)
+		success = shortest_remaining_time_first_stream(stream, &result, &outputs);
+	else if(strcmp(algorithm, P) == 0 || strcmp(algorithm, PP) == 0)
+		success = priority_stream(stream, &result, &priority_config, &outputs);
+	else if(strcmp(algorithm, MLFQ) == 0)
+		success = multilevel_feedback_queue_stream(stream, &result, &mlfq, &outputs);
+	else
+	{
+		fprintf(stderr, "Error: algorithm '%s' cannot be streamed\n", algorithm);
+		fprintf(stderr, "Valid options: FCFS, SJF, P, PP, RR, SRT, MLFQ\n");
+		pcb_stream_close(stream);
+		return EXIT_FAILURE;
+	}
+	pcb_stream_close(stream);
+
+	if(!success)
+	{
+		fprintf(stderr, "Error: streaming '%s' failed (the file must be complete, and in arrival order"
+						" for everything but FCFS).\n", algorithm);
+		return EXIT_FAILURE;
+	}
+
+	printf("Algorithm: %s\n",  algorithm);
+	printf("Average Waiting Time: %.2f\n", result.average_waiting_time);
+	printf("Average Turnaround Time: %.2f\n", result.average_turnaround_time);
+	printf("Total Run Time: %lu\n",  result.total_run_time);
+	print_stats(&stats);
+	return EXIT_SUCCESS;
+}
+
 // Add and comment your analysis code in this function.
 int main(int argc, char **argv) 
 {
+	// stream mode: schedule straight from the file, one PCB at a time
+	if(argc >= 4 && strcmp(argv[1], "--stream") == 0)
+		return run_stream(argv[2], argv[3], argc > 4 ? argv[4] : NULL, argc > 5 ? argv[5] : NULL);
+
 	if (argc < 3) 
 	{
 		printf("%s <pcb file> <schedule algorithm> [quantum]\n", argv[0]);
+		printf("%s <pcb file> ALL|<algorithm,algorithm,...> [quantum, %d for RR under ALL]\n", argv[0], SCHEDULE_ALL_QUANTUM);
+		printf("%s <pcb file> RR <first quantum>:<last quantum>[:step]\n", argv[0]);
+		printf("%s <pcb file> MLFQ <quantum,quantum,...> [boost interval]\n", argv[0]);
+		printf("%s <pcb file> P|PP [aging interval]\n", argv[0]);
+		printf("%s --stream <pcb file> FCFS|SJF|RR|SRT [quantum]\n", argv[0]);
+		printf("%s --stream <pcb file> P|PP [aging interval]\n", argv[0]);
+		printf("%s --stream <pcb file> MLFQ <quantum,quantum,...> [boost interval]\n", argv[0]);
 		return EXIT_FAILURE;
 	}
 
 	const char* pcb_file  = argv[1];
 	const char* algorithm = argv[2];
 
+	// batch mode: several algorithms, one load
+	if(strcmp(algorithm, ALL) == 0 || strchr(algorithm, ',') != NULL || strchr(algorithm, ':') != NULL)
+		return run_batch(pcb_file, algorithm, argc > 3 ? argv[3] : NULL);
+
+	// sweep mode: round robin over a range of quanta, one load
+	if(strcmp(algorithm, RR) == 0 && argc > 3 && strchr(argv[3], ':') != NULL)
+		return run_sweep(pcb_file, argv[3]);
+
 	// load the process control blocks from the binary file
 	dyn_array_t* ready_queue = load_process_control_blocks(pcb_file);
 	if(ready_queue == NULL)
@@ -35,6 +302,10 @@ int main(int argc, char **argv)
 	result.average_turnaround_time = 0.0f;
 	result.total_run_time          = 0;
 
+	// every algorithm also reports the tail of its per-process times
+	ScheduleStats_t stats;
+	ScheduleOutputs_t outputs = { NULL, &stats };
+
 	bool success = false;
 
 	char algo_buf[8];
@@ -47,15 +318,24 @@ int main(int argc, char **argv)
 
 	if(sscanf(algo_buf, FCFS) == 0 && algo_buf[0] == 'F')
 	{
-		success = first_come_first_serve(ready_queue, &result);
+		success = first_come_first_serve_detailed(ready_queue, &result, &outputs);
 	}
 	else if(algo_buf[0] == 'S' && algo_buf[1] == 'J')
 	{
-		success = shortest_job_first(ready_queue, &result);
+		success = shortest_job_first_detailed(ready_queue, &result, &outputs);
 	}
-	else if(algo_buf[0] == 'P' && algo_buf[1] == '\0')
+	else if(strcmp(algo_buf, P) == 0 || strcmp(algo_buf, PP) == 0)
 	{
-		success = priority(ready_queue, &result);
+		// PP preempts on arrivals, either ages waiting jobs if given an interval
+		PriorityConfig_t config = { algo_buf[1] == 'P', 0 };
+		if(!parse_aging(argc > 3 ? argv[3] : NULL, &config.aging_interval))
+		{
+			fprintf(stderr, "Error: the aging interval must be a non-negative integer.\n");
+			dyn_array_destroy(ready_queue);
+			return EXIT_FAILURE;
+		}
+
+		success = priority_detailed(ready_queue, &result, &config, &outputs);
 	}
 	else if(algo_buf[0] == 'R' && algo_buf[1] == 'R')
 	{
@@ -75,16 +355,30 @@ int main(int argc, char **argv)
 			return EXIT_FAILURE;
 		}
 
-		success = round_robin(ready_queue, &result, quantum);
+		success = round_robin_detailed(ready_queue, &result, quantum, &outputs);
 	}
 	else if(algo_buf[0] == 'S' && algo_buf[1] == 'R')
 	{
-		success = shortest_remaining_time_first(ready_queue, &result);
+		success = shortest_remaining_time_first_detailed(ready_queue, &result, &outputs);
+	}
+	else if(strcmp(algo_buf, MLFQ) == 0)
+	{
+		size_t quanta[MLFQ_MAX_LEVELS];
+		MlfqConfig_t mlfq;
+		if(!parse_mlfq(argc > 3 ? argv[3] : NULL, argc > 4 ? argv[4] : NULL, quanta, &mlfq))
+		{
+			fprintf(stderr, "Error: MLFQ requires positive quanta, top level first, and an optional boost interval.\n");
+			fprintf(stderr, "Usage: %s <pcb file> MLFQ <quantum,quantum,...> [boost interval]\n", argv[0]);
+			dyn_array_destroy(ready_queue);
+			return EXIT_FAILURE;
+		}
+
+		success = multilevel_feedback_queue_detailed(ready_queue, &result, &mlfq, &outputs);
 	}
 	else
 	{
 		fprintf(stderr, "Error: unknown algorithm '%s'\n", algorithm);
-		fprintf(stderr, "Valid options: FCFS, SJF, P, RR, SRT\n");
+		fprintf(stderr, "Valid options: FCFS, SJF, P, PP, RR, SRT, MLFQ\n");
 		dyn_array_destroy(ready_queue);
 		return EXIT_FAILURE;
 	}
@@ -101,6 +395,7 @@ int main(int argc, char **argv)
 	printf("Average Waiting Time: %.2f\n", result.average_waiting_time);
 	printf("Average Turnaround Time: %.2f\n", result.average_turnaround_time);
 	printf("Total Run Time: %lu\n",  result.total_run_time);
+	print_stats(&stats);
 
 	return EXIT_SUCCESS;
 }
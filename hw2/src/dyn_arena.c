@@ -0,0 +1,221 @@
+#include "dyn_arena.h"
+
+// blocks are a singly linked list, current is the one being bumped
+// everything before current is full (or was skipped for being too small), everything after is spare
+// [used][used][current: used | free][spare][spare]
+typedef struct dyn_arena_block
+{
+	struct dyn_arena_block *next;
+	size_t size;	// usable bytes after the header
+	size_t used;
+} dyn_arena_block_t;
+
+struct dyn_arena
+{
+	size_t block_size;
+	dyn_arena_block_t *first;
+	dyn_arena_block_t *current;
+	size_t blocks;
+	size_t used;			// bytes handed out since the last reset
+};
+
+#define DYN_ARENA_DEFAULT_BLOCK (((size_t) 1) << 20)
+// every allocation (and the block header) is padded to this, enough for any type
+#define DYN_ARENA_ALIGN ((size_t) _Alignof(max_align_t))
+#define DYN_ARENA_ROUND(bytes) (((bytes) + DYN_ARENA_ALIGN - 1) & ~(DYN_ARENA_ALIGN - 1))
+#define DYN_ARENA_HEADER DYN_ARENA_ROUND(sizeof(dyn_arena_block_t))
+// start of a block's memory
+#define DYN_ARENA_DATA(block_ptr) (((uint8_t *) (block_ptr)) + DYN_ARENA_HEADER)
+// the latest allocation in the current block, the only kind that can grow in place or be given back
+#define DYN_ARENA_IS_TOP(block_ptr, ptr, size)											\
+	((block_ptr) && DYN_ARENA_ROUND(size) <= (block_ptr)->used							\
+	 && (uint8_t *) (ptr) == DYN_ARENA_DATA(block_ptr) + (block_ptr)->used - DYN_ARENA_ROUND(size))
+
+
+// Moves current on to a block with room for size bytes, allocating one if no spare block fits
+static bool dyn_arena_next_block(dyn_arena_t *const dyn_arena, const size_t size);
+
+// The dyn_allocator_t face of an arena
+static void *dyn_arena_allocate(void *context, size_t size);
+static void *dyn_arena_reallocate(void *context, void *ptr, size_t old_size, size_t new_size);
+static void dyn_arena_release(void *context, void *ptr, size_t size);
+
+
+
+
+dyn_arena_t *dyn_arena_create(const size_t block_size)
+{
+	dyn_arena_t *dyn_arena = (dyn_arena_t *) malloc(sizeof(dyn_arena_t));
+	if (dyn_arena)
+	{
+		dyn_arena->block_size = block_size ? DYN_ARENA_ROUND(block_size) : DYN_ARENA_DEFAULT_BLOCK;
+		dyn_arena->first	  = NULL;
+		dyn_arena->current	  = NULL;
+		dyn_arena->blocks	  = 0;
+		dyn_arena->used		  = 0;
+	}
+	return dyn_arena;
+}
+
+void dyn_arena_destroy(dyn_arena_t *const dyn_arena)
+{
+	if (dyn_arena)
+	{
+		dyn_arena_block_t *block = dyn_arena->first;
+		while (block)
+		{
+			dyn_arena_block_t *next = block->next;
+			free(block);
+			block = next;
+		}
+		free(dyn_arena);
+	}
+}
+
+void *dyn_arena_alloc(dyn_arena_t *const dyn_arena, const size_t size)
+{
+	if (dyn_arena && size && size <= SIZE_MAX - DYN_ARENA_HEADER - DYN_ARENA_ALIGN)
+	{
+		const size_t rounded = DYN_ARENA_ROUND(size);
+		dyn_arena_block_t *block = dyn_arena->current;
+		if (!block || block->size - block->used < rounded)
+		{
+			if (!dyn_arena_next_block(dyn_arena, rounded))
+			{
+				return NULL;
+			}
+			block = dyn_arena->current;
+		}
+		void *ptr = DYN_ARENA_DATA(block) + block->used;
+		block->used		+= rounded;
+		dyn_arena->used += rounded;
+		return ptr;
+	}
+	return NULL;
+}
+
+void dyn_arena_reset(dyn_arena_t *const dyn_arena)
+{
+	if (dyn_arena)
+	{
+		// blocks after the first are emptied as current reaches them again, not here
+		dyn_arena->current = dyn_arena->first;
+		if (dyn_arena->current)
+		{
+			dyn_arena->current->used = 0;
+		}
+		dyn_arena->used = 0;
+	}
+}
+
+bool dyn_arena_allocator(dyn_arena_t *const dyn_arena, dyn_allocator_t *const allocator)
+{
+	if (dyn_arena && allocator)
+	{
+		allocator->allocate	  = dyn_arena_allocate;
+		allocator->reallocate = dyn_arena_reallocate;
+		allocator->release	  = dyn_arena_release;
+		allocator->context	  = dyn_arena;
+		return true;
+	}
+	return false;
+}
+
+size_t dyn_arena_blocks(const dyn_arena_t *const dyn_arena)
+{
+	return dyn_arena ? dyn_arena->blocks : 0;
+}
+
+size_t dyn_arena_used(const dyn_arena_t *const dyn_arena)
+{
+	return dyn_arena ? dyn_arena->used : 0;
+}
+
+
+
+
+static bool dyn_arena_next_block(dyn_arena_t *const dyn_arena, const size_t size)
+{
+	dyn_arena_block_t *current = dyn_arena->current;
+	dyn_arena_block_t *next	   = current ? current->next : dyn_arena->first;
+	if (next && next->size >= size)
+	{
+		next->used		   = 0;
+		dyn_arena->current = next;
+		return true;
+	}
+
+	// a spare block that's too small stays where it is, the new one goes in front of it
+	const size_t block_size = size > dyn_arena->block_size ? size : dyn_arena->block_size;
+	dyn_arena_block_t *block = (dyn_arena_block_t *) malloc(DYN_ARENA_HEADER + block_size);
+	if (block)
+	{
+		block->next = next;
+		block->size = block_size;
+		block->used = 0;
+		if (current)
+		{
+			current->next = block;
+		}
+		else
+		{
+			dyn_arena->first = block;
+		}
+		dyn_arena->current = block;
+		dyn_arena->blocks++;
+		return true;
+	}
+	return false;
+}
+
+static void *dyn_arena_allocate(void *context, size_t size)
+{
+	return dyn_arena_alloc((dyn_arena_t *) context, size);
+}
+
+static void *dyn_arena_reallocate(void *context, void *ptr, size_t old_size, size_t new_size)
+{
+	dyn_arena_t *dyn_arena = (dyn_arena_t *) context;
+	if (!ptr)
+	{
+		return dyn_arena_alloc(dyn_arena, new_size);
+	}
+
+	// the latest allocation can grow or shrink where it is while its block has room
+	dyn_arena_block_t *block = dyn_arena->current;
+	if (new_size && DYN_ARENA_IS_TOP(block, ptr, old_size))
+	{
+		const size_t offset		 = (size_t) ((uint8_t *) ptr - DYN_ARENA_DATA(block));
+		const size_t new_rounded = DYN_ARENA_ROUND(new_size);
+		if (new_size <= SIZE_MAX - DYN_ARENA_ALIGN && new_rounded <= block->size - offset)
+		{
+			dyn_arena->used = dyn_arena->used - (block->used - offset) + new_rounded;
+			block->used		= offset + new_rounded;
+			return ptr;
+		}
+	}
+	else if (new_size && new_size <= old_size)
+	{
+		return ptr;
+	}
+
+	void *new_ptr = dyn_arena_alloc(dyn_arena, new_size);
+	if (new_ptr)
+	{
+		memcpy(new_ptr, ptr, old_size < new_size ? old_size : new_size);
+	}
+	return new_ptr;
+}
+
+static void dyn_arena_release(void *context, void *ptr, size_t size)
+{
+	dyn_arena_t *dyn_arena = (dyn_arena_t *) context;
+	// only the top of the current block can be taken back, everything else waits for a reset
+	// so releasing in reverse order of allocation (like dyn_array_destroy does) gives it all back
+	dyn_arena_block_t *block = dyn_arena->current;
+	if (ptr && DYN_ARENA_IS_TOP(block, ptr, size))
+	{
+		block->used		-= DYN_ARENA_ROUND(size);
+		dyn_arena->used -= DYN_ARENA_ROUND(size);
+	}
+}
@@ -1,3 +1,7 @@
+// posix_memalign, and madvise/MADV_HUGEPAGE on Linux
+#define _DEFAULT_SOURCE
+#include <sys/mman.h>
+
 #include "dyn_array.h"
 
 // Flag values
@@ -14,6 +18,8 @@ struct dyn_array
 	const size_t data_size;
 	void *array;
 	void (*destructor)(void *);
+	dyn_array_policy_t policy;
+	dyn_allocator_t allocator;
 };
 
 // Supports 64bit+ size_t!
@@ -29,6 +35,34 @@ struct dyn_array
 // Gets the size (in bytes) of n dyn_array elements
 #define DYN_SIZE_N_ELEMS(dyn_array_ptr, n) ((dyn_array_ptr)->data_size * (n))
 
+// Allocations at least this big get hugepage alignment when the policy asks for it
+#define DYN_HUGEPAGE_SIZE (((size_t) 2) << 20)
+
+static const dyn_array_policy_t DYN_DEFAULT_POLICY = {2.0, 0.0, 16, false};
+
+// The allocator behind a NULL allocator, plain malloc/realloc/free
+static void *dyn_malloc_allocate(void *context, size_t size) 
+{
+	(void) context;
+	return malloc(size);
+}
+
+static void *dyn_malloc_reallocate(void *context, void *ptr, size_t old_size, size_t new_size) 
+{
+	(void) context;
+	(void) old_size;
+	return realloc(ptr, new_size);
+}
+
+static void dyn_malloc_release(void *context, void *ptr, size_t size) 
+{
+	(void) context;
+	(void) size;
+	free(ptr);
+}
+
+static const dyn_allocator_t DYN_MALLOC_ALLOCATOR = {dyn_malloc_allocate, dyn_malloc_reallocate, dyn_malloc_release, NULL};
+
 
 
 // Modes of operation for dyn_shift
@@ -43,14 +77,40 @@ bool dyn_shift_insert(dyn_array_t *const dyn_array, const size_t position, const
 bool dyn_shift_remove(dyn_array_t *const dyn_array, const size_t position, const size_t count,
 					  const DYN_SHIFT_MODE mode, void *const data_dst);
 
+// Checks to see if the object can handle an increase in size (and optionally increases capacity)
+bool dyn_request_size_increase(dyn_array_t *const dyn_array, const size_t increment);
+
+// Gives back memory once the object has drained far enough below capacity, if its policy shrinks at all
+void dyn_request_size_decrease(dyn_array_t *const dyn_array);
+
+// Moves the contents to an allocation of at least new_capacity objects, the only place the array is reallocated
+bool dyn_set_capacity(dyn_array_t *const dyn_array, size_t new_capacity);
+
+// Sorting internals, written against a size argument so constant sizes get their own specialised copies
+static inline void dyn_copy_object(void *const dst, const void *const src, const size_t size);
+static inline uint64_t dyn_load_key(const uint8_t *const key, const size_t key_size);
+static void dyn_introsort(uint8_t *base, size_t count, const size_t size,
+						  int (*const compare)(const void *, const void *), size_t depth);
+
 
 
 
 dyn_array_t *dyn_array_create(const size_t capacity, const size_t data_type_size, void (*destruct_func)(void *)) 
 {
+	return dyn_array_create_with_allocator(capacity, data_type_size, destruct_func, NULL);
+}
+
+dyn_array_t *dyn_array_create_with_allocator(const size_t capacity, const size_t data_type_size,
+											 void (*destruct_func)(void *), const dyn_allocator_t *const allocator) 
+{
+	if (allocator && !(allocator->allocate && allocator->reallocate && allocator->release)) 
+	{
+		return NULL;
+	}
+	const dyn_allocator_t *const alloc = allocator ? allocator : &DYN_MALLOC_ALLOCATOR;
 	if (data_type_size && capacity <= DYN_MAX_CAPACITY) 
 	{
-		dyn_array_t *dyn_array = (dyn_array_t *) malloc(sizeof(dyn_array_t));
+		dyn_array_t *dyn_array = (dyn_array_t *) alloc->allocate(alloc->context, sizeof(dyn_array_t));
 		if (dyn_array) 
 		{
 			// would have inf loop if requested size was between DYN_MAX_CAPACITY
@@ -71,7 +131,8 @@ dyn_array_t *dyn_array_create(const size_t capacity, const size_t data_type_size
 			// I had an idea... and it compiles
 			// const members of a malloc'd struct are so annoying
 			memcpy(dyn_array, &((dyn_array_t){actual_capacity, 0, data_type_size,
-											  malloc(data_type_size * actual_capacity), destruct_func}),
+											  alloc->allocate(alloc->context, data_type_size * actual_capacity),
+											  destruct_func, DYN_DEFAULT_POLICY, *alloc}),
 				   sizeof(dyn_array_t));
 
 			if (dyn_array->array) 
@@ -80,12 +141,33 @@ dyn_array_t *dyn_array_create(const size_t capacity, const size_t data_type_size
 				// we're done?
 				return dyn_array;
 			}
-			free(dyn_array);
+			alloc->release(alloc->context, dyn_array, sizeof(dyn_array_t));
 		}
 	}
 	return NULL;
 }
 
+void dyn_array_policy_defaults(dyn_array_policy_t *const policy) 
+{
+	if (policy) 
+	{
+		*policy = DYN_DEFAULT_POLICY;
+	}
+}
+
+bool dyn_array_set_policy(dyn_array_t *const dyn_array, const dyn_array_policy_t *const policy) 
+{
+	// a shrink has to leave the array below the threshold's reach, or the next removal shrinks again
+	if (dyn_array && policy && policy->growth_factor > 1.0 && policy->min_capacity 
+		&& policy->shrink_threshold >= 0.0 && policy->shrink_threshold * policy->growth_factor < 1.0) 
+	{
+		dyn_array->policy = *policy;
+		dyn_request_size_decrease(dyn_array);
+		return true;
+	}
+	return false;
+}
+
 // Creates a dynamic array from a standard array
 dyn_array_t *dyn_array_import(const void *const data, const size_t count, const size_t data_type_size,
 							  void (*destruct_func)(void *)) 
@@ -119,9 +201,11 @@ const void *dyn_array_export(const dyn_array_t *const dyn_array)
 void dyn_array_destroy(dyn_array_t *dyn_array) 
 {
 	if (dyn_array) {
+		// copied out first, the allocator lives inside what it's releasing
+		const dyn_allocator_t allocator = dyn_array->allocator;
 		dyn_array_clear(dyn_array);
-		free(dyn_array->array);
-		free(dyn_array);
+		allocator.release(allocator.context, dyn_array->array, DYN_SIZE_N_ELEMS(dyn_array, dyn_array->capacity));
+		allocator.release(allocator.context, dyn_array, sizeof(dyn_array_t));
 	}
 }
 
@@ -184,6 +268,55 @@ bool dyn_array_extract_back(dyn_array_t *const dyn_array, void *const object)
 	return dyn_array && dyn_array->size && dyn_shift_remove(dyn_array, dyn_array->size - 1, 1, MODE_EXTRACT, object);
 }
 
+bool dyn_array_push_back_n(dyn_array_t *const dyn_array, const void *const objects, const size_t count) 
+{
+	// one capacity check and one memcpy for the lot, instead of one of each per object
+	if (dyn_array && objects) 
+	{
+		return count == 0 || dyn_shift_insert(dyn_array, dyn_array->size, count, MODE_INSERT, objects);
+	}
+	return false;
+}
+
+bool dyn_array_extract_front_n(dyn_array_t *const dyn_array, void *const objects, const size_t count) 
+{
+	// the tail is moved up once, extracting one at a time would move it count times
+	if (dyn_array && objects) 
+	{
+		return count == 0 || dyn_shift_remove(dyn_array, 0, count, MODE_EXTRACT, objects);
+	}
+	return false;
+}
+
+bool dyn_array_reserve(dyn_array_t *const dyn_array, const size_t capacity) 
+{
+	if (dyn_array && capacity <= DYN_MAX_CAPACITY) 
+	{
+		// straight to the requested capacity in one realloc, no growth factor on top
+		return capacity <= dyn_array->capacity || dyn_set_capacity(dyn_array, capacity);
+	}
+	return false;
+}
+
+dyn_array_t *dyn_array_clone(const dyn_array_t *const dyn_array) 
+{
+	if (dyn_array) 
+	{
+		dyn_array_t *clone = dyn_array_create_with_allocator(dyn_array->size, dyn_array->data_size, dyn_array->destructor,
+															 &dyn_array->allocator);
+		if (clone) 
+		{
+			if (dyn_array->size) 
+			{
+				memcpy(clone->array, dyn_array->array, DYN_SIZE_N_ELEMS(dyn_array, dyn_array->size));
+			}
+			clone->size   = dyn_array->size;
+			clone->policy = dyn_array->policy;
+			return clone;
+		}
+	}
+	return NULL;
+}
 
 void *dyn_array_at(const dyn_array_t *const dyn_array, const size_t index) 
 {
@@ -257,11 +390,95 @@ size_t dyn_array_data_size(const dyn_array_t *const dyn_array)
 
 bool dyn_array_sort(dyn_array_t *const dyn_array, int (*const compare)(const void *, const void *)) 
 {
-	// hah, turns out there's a quicksort in cstdlib.
-	// and it works exactly like we want it to
+	// turns out there's a quicksort in cstdlib, but it swaps byte by byte
+	// and can't know the object size ahead of time, so we do our own
 	if (dyn_array && dyn_array->size && compare) 
 	{
-		qsort(dyn_array->array, dyn_array->size, dyn_array->data_size, compare);
+		size_t depth = 0;
+		for (size_t n = dyn_array->size; n > 1; n >>= 1) 
+		{
+			depth += 2;
+		}
+		// constant sizes let the compiler specialise the whole sort, swaps become a few word moves
+		uint8_t *const base = (uint8_t *) dyn_array->array;
+		switch (dyn_array->data_size) 
+		{
+			case 4: dyn_introsort(base, dyn_array->size, 4, compare, depth); break;
+			case 8: dyn_introsort(base, dyn_array->size, 8, compare, depth); break;
+			case 16: dyn_introsort(base, dyn_array->size, 16, compare, depth); break;
+			case 32: dyn_introsort(base, dyn_array->size, 32, compare, depth); break;
+			default: dyn_introsort(base, dyn_array->size, dyn_array->data_size, compare, depth); break;
+		}
+		return true;
+	}
+	return false;
+}
+
+bool dyn_array_sort_by_key(dyn_array_t *const dyn_array, const size_t key_offset, const size_t key_size) 
+{
+	if (dyn_array && dyn_array->size && (key_size == 1 || key_size == 2 || key_size == 4 || key_size == 8)
+		&& key_offset <= dyn_array->data_size && key_size <= dyn_array->data_size - key_offset) 
+	{
+		const size_t n	  = dyn_array->size;
+		const size_t size = dyn_array->data_size;
+		if (n < 2) 
+		{
+			return true;
+		}
+
+		// one pass over the keys counts the digits of every byte at once
+		size_t counts[8][256] = {{0}};
+		const uint8_t *walker = (const uint8_t *) dyn_array->array + key_offset;
+		for (size_t idx = 0; idx < n; ++idx, walker += size) 
+		{
+			uint64_t key = dyn_load_key(walker, key_size);
+			for (size_t byte = 0; byte < key_size; ++byte, key >>= 8) 
+			{
+				++counts[byte][key & 0xFF];
+			}
+		}
+
+		const dyn_allocator_t *allocator = &dyn_array->allocator;
+		uint8_t *scratch = (uint8_t *) allocator->allocate(allocator->context, DYN_SIZE_N_ELEMS(dyn_array, n));
+		if (!scratch) 
+		{
+			return false;
+		}
+		uint8_t *src = (uint8_t *) dyn_array->array;
+		uint8_t *dst = scratch;
+		for (size_t byte = 0; byte < key_size; ++byte) 
+		{
+			// a byte every key shares wouldn't move anything, e.g. the high bytes of small arrival times
+			const uint64_t first = dyn_load_key(src + key_offset, key_size) >> (byte * 8) & 0xFF;
+			if (counts[byte][first] == n) 
+			{
+				continue;
+			}
+
+			size_t offsets[256];
+			size_t total = 0;
+			for (size_t digit = 0; digit < 256; ++digit) 
+			{
+				offsets[digit] = total;
+				total += counts[byte][digit];
+			}
+			const uint8_t *object = src;
+			for (size_t idx = 0; idx < n; ++idx, object += size) 
+			{
+				const size_t digit = dyn_load_key(object + key_offset, key_size) >> (byte * 8) & 0xFF;
+				dyn_copy_object(dst + offsets[digit]++ * size, object, size);
+			}
+			uint8_t *swap = src;
+			src			  = dst;
+			dst			  = swap;
+		}
+
+		// an odd number of passes left the result in scratch
+		if (src != dyn_array->array) 
+		{
+			memcpy(dyn_array->array, src, DYN_SIZE_N_ELEMS(dyn_array, n));
+		}
+		allocator->release(allocator->context, scratch, DYN_SIZE_N_ELEMS(dyn_array, n));
 		return true;
 	}
 	return false;
@@ -311,18 +528,11 @@ bool dyn_array_for_each(dyn_array_t *const dyn_array, void (*const func)(void *c
 }
 
 
-/*
-	// No return value. It either goes or it doesn't. shrink_to_fit is more of a request
-	void dyn_array_shrink_to_fit(dyn_array_t *const dyn_array) {
-	if (dyn_array) {
-		void *new_address = realloc(dyn_array->data, DYN_ARRAY_SIZE_N_ELEMS(dyn_array, dyn_array->size));
-		if (new_address) {
-			dyn_array->data = new_address;
-			SET_FLAG(dyn_array,SHRUNK);
-		}
-	}
-	}
-*/
+bool dyn_array_shrink_to_fit(dyn_array_t *const dyn_array) 
+{
+	// realloc to 0 bytes may free the array, so an empty array keeps room for one
+	return dyn_array && dyn_set_capacity(dyn_array, dyn_array->size ? dyn_array->size : 1);
+}
 
 
 
@@ -334,9 +544,6 @@ bool dyn_array_for_each(dyn_array_t *const dyn_array, void (*const func)(void *c
 //
 
 
-// Checks to see if the object can handle an increase in size (and optionally increases capacity)
-bool dyn_request_size_increase(dyn_array_t *const dyn_array, const size_t increment);
-
 #define MODE_IS_TYPE(mode, type) ((mode) & (type))
 
 // inserting between idx 1 and 2 (between B and C) means you're moving everything from 2 down to make room
@@ -417,6 +624,7 @@ bool dyn_shift_remove(dyn_array_t *const dyn_array, const size_t position, const
 		}
 		// decrease the size and return
 		dyn_array->size -= count;
+		dyn_request_size_decrease(dyn_array);
 		return true;
 	}
 	return false;
@@ -439,28 +647,246 @@ bool dyn_request_size_increase(dyn_array_t *const dyn_array, const size_t increm
 		// have to reallocate, is that even possible?
 		size_t needed_size = dyn_array->size + increment;
 
-		// INSERT SHRINK_TO_FIT CORRECTION HERE
-
 		if (needed_size <= DYN_MAX_CAPACITY) 
 		{
-			size_t new_capacity = dyn_array->capacity << 1;
+			// the default factor of 2 keeps capacities at powers of two, like create does
+			size_t new_capacity = dyn_array->capacity;
 			while (new_capacity < needed_size) 
 			{
-				new_capacity <<= 1;
+				double grown = (double) new_capacity * dyn_array->policy.growth_factor;
+				size_t next	 = grown < (double) DYN_MAX_CAPACITY ? (size_t) grown : DYN_MAX_CAPACITY;
+				// a factor barely over 1 still has to get somewhere on a small capacity
+				new_capacity = next > new_capacity ? next : new_capacity + 1;
 			}
 
 			// we can theoretically hold this, check if we can allocate that
 			// if (!MULTIPLY_MAY_OVERFLOW(new_capacity, dyn_array->data_size)) {
 			// we won't overflow, so we can at least REQUEST this change
-			void *new_array = realloc(dyn_array->array, new_capacity * dyn_array->data_size);
-			if (new_array) 
+			return dyn_set_capacity(dyn_array, new_capacity);
+		}
+	}
+	return false;
+}
+
+void dyn_request_size_decrease(dyn_array_t *const dyn_array) 
+{
+	const dyn_array_policy_t *policy = &dyn_array->policy;
+	if (policy->shrink_threshold > 0.0 && dyn_array->capacity > policy->min_capacity
+		&& (double) dyn_array->size < policy->shrink_threshold * (double) dyn_array->capacity) 
+	{
+		// shrink to what growing from here would have picked, one factor above the size
+		// that's the hysteresis, it takes a whole growth to get back to the old capacity
+		size_t new_capacity = (size_t) ((double) dyn_array->size * policy->growth_factor) + 1;
+		if (new_capacity < policy->min_capacity) 
+		{
+			new_capacity = policy->min_capacity;
+		}
+		if (new_capacity < dyn_array->capacity) 
+		{
+			// just a request, the array is fine as it is if this fails
+			dyn_set_capacity(dyn_array, new_capacity);
+		}
+	}
+}
+
+bool dyn_set_capacity(dyn_array_t *const dyn_array, size_t new_capacity) 
+{
+	size_t bytes = DYN_SIZE_N_ELEMS(dyn_array, new_capacity);
+	const dyn_allocator_t *allocator = &dyn_array->allocator;
+	// hugepages are a heap thing, any other allocator places memory its own way
+	if (dyn_array->policy.hugepage_align && bytes >= DYN_HUGEPAGE_SIZE && allocator->allocate == dyn_malloc_allocate) 
+	{
+		// whole hugepages only, whatever rounding up adds becomes capacity
+		bytes		 = (bytes + DYN_HUGEPAGE_SIZE - 1) & ~(DYN_HUGEPAGE_SIZE - 1);
+		new_capacity = bytes / dyn_array->data_size;
+		if (new_capacity == dyn_array->capacity) 
+		{
+			return true;
+		}
+
+		// realloc doesn't keep alignment, so this one is a fresh block and a copy
+		void *new_array = NULL;
+		if (posix_memalign(&new_array, DYN_HUGEPAGE_SIZE, bytes) == 0) 
+		{
+#ifdef MADV_HUGEPAGE
+			// only advice, transparent hugepages may be off
+			madvise(new_array, bytes, MADV_HUGEPAGE);
+#endif
+			if (dyn_array->size) 
 			{
-				// success! Wasn't that easy?
-				dyn_array->array	= new_array;
-				dyn_array->capacity = new_capacity;
-				return true;
+				memcpy(new_array, dyn_array->array, DYN_SIZE_N_ELEMS(dyn_array, dyn_array->size));
 			}
+			free(dyn_array->array);
+			dyn_array->array	= new_array;
+			dyn_array->capacity = new_capacity;
+			return true;
 		}
+		return false;
+	}
+
+	void *new_array = allocator->reallocate(allocator->context, dyn_array->array,
+											DYN_SIZE_N_ELEMS(dyn_array, dyn_array->capacity), bytes);
+	if (new_array) 
+	{
+		// success! Wasn't that easy?
+		dyn_array->array	= new_array;
+		dyn_array->capacity = new_capacity;
+		return true;
 	}
 	return false;
 }
+
+// Sizes the sort internals are tuned for get fixed-size copies the compiler turns into plain moves
+static inline void dyn_copy_object(void *const dst, const void *const src, const size_t size) 
+{
+	switch (size) 
+	{
+		case 4: memcpy(dst, src, 4); break;
+		case 8: memcpy(dst, src, 8); break;
+		case 16: memcpy(dst, src, 16); break;
+		case 32: memcpy(dst, src, 32); break;
+		default: memcpy(dst, src, size); break;
+	}
+}
+
+static inline void dyn_swap_objects(uint8_t *const a, uint8_t *const b, const size_t size) 
+{
+	// big objects go through the temporary a chunk at a time
+	uint8_t temp[64];
+	for (size_t done = 0; done < size; done += sizeof(temp)) 
+	{
+		const size_t chunk = size - done < sizeof(temp) ? size - done : sizeof(temp);
+		dyn_copy_object(temp, a + done, chunk);
+		dyn_copy_object(a + done, b + done, chunk);
+		dyn_copy_object(b + done, temp, chunk);
+	}
+}
+
+static inline uint64_t dyn_load_key(const uint8_t *const key, const size_t key_size) 
+{
+	switch (key_size) 
+	{
+		case 1: return *key;
+		case 2: { uint16_t value; memcpy(&value, key, 2); return value; }
+		case 4: { uint32_t value; memcpy(&value, key, 4); return value; }
+		default: { uint64_t value; memcpy(&value, key, 8); return value; }
+	}
+}
+
+// Plain insertion sort for the short runs quicksort leaves behind
+static inline void dyn_insertion_sort(uint8_t *const base, const size_t count, const size_t size,
+									  int (*const compare)(const void *, const void *)) 
+{
+	for (size_t idx = 1; idx < count; ++idx) 
+	{
+		for (uint8_t *object = base + idx * size; object > base && compare(object - size, object) > 0; object -= size) 
+		{
+			dyn_swap_objects(object - size, object, size);
+		}
+	}
+}
+
+// Heapsort, only reached when quicksort keeps picking bad pivots
+static void dyn_heapsort(uint8_t *const base, const size_t count, const size_t size,
+						 int (*const compare)(const void *, const void *)) 
+{
+	for (size_t end = count, start = count / 2; end > 1; ) 
+	{
+		// build the heap first (start counting down), then keep moving the max to the end
+		size_t root;
+		if (start > 0) 
+		{
+			root = --start;
+		} 
+		else 
+		{
+			--end;
+			dyn_swap_objects(base, base + end * size, size);
+			root = 0;
+		}
+		for (size_t child = 2 * root + 1; child < end; child = 2 * root + 1) 
+		{
+			if (child + 1 < end && compare(base + child * size, base + (child + 1) * size) < 0) 
+			{
+				++child;
+			}
+			if (compare(base + root * size, base + child * size) >= 0) 
+			{
+				break;
+			}
+			dyn_swap_objects(base + root * size, base + child * size, size);
+			root = child;
+		}
+	}
+}
+
+// Quicksort with a median of three pivot, recursing on the smaller side so the stack stays O(log n)
+// Past depth levels it gives up on quicksort for that range and heapsorts it
+static void dyn_introsort(uint8_t *base, size_t count, const size_t size,
+						  int (*const compare)(const void *, const void *), size_t depth) 
+{
+	while (count > 16) 
+	{
+		if (depth == 0) 
+		{
+			dyn_heapsort(base, count, size, compare);
+			return;
+		}
+		--depth;
+
+		// order first, middle and last, the middle one becomes the pivot at index 1
+		// and the other two stop both scans from running off the ends
+		uint8_t *const middle = base + (count / 2) * size;
+		uint8_t *const last	  = base + (count - 1) * size;
+		if (compare(middle, base) < 0) 
+		{
+			dyn_swap_objects(middle, base, size);
+		}
+		if (compare(last, middle) < 0) 
+		{
+			dyn_swap_objects(last, middle, size);
+			if (compare(middle, base) < 0) 
+			{
+				dyn_swap_objects(middle, base, size);
+			}
+		}
+		uint8_t *const pivot = base + size;
+		dyn_swap_objects(middle, pivot, size);
+
+		// Hoare partition, both scans stop on equal objects so runs of duplicates split evenly
+		size_t left = 1, right = count - 1;
+		for (;;) 
+		{
+			do 
+			{
+				++left;
+			} while (compare(base + left * size, pivot) < 0);
+			do 
+			{
+				--right;
+			} while (compare(pivot, base + right * size) < 0);
+			if (left >= right) 
+			{
+				break;
+			}
+			dyn_swap_objects(base + left * size, base + right * size, size);
+		}
+		dyn_swap_objects(pivot, base + right * size, size);
+
+		// [0, right) <= pivot <= (right, count)
+		const size_t below = right;
+		const size_t above = count - right - 1;
+		if (below < above) 
+		{
+			dyn_introsort(base, below, size, compare, depth);
+			base += (right + 1) * size;
+			count = above;
+		} 
+		else 
+		{
+			dyn_introsort(base + (right + 1) * size, above, size, compare, depth);
+			count = below;
+		}
+	}
+	dyn_insertion_sort(base, count, size, compare);
+}
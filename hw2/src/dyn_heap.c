@@ -0,0 +1,365 @@
+#include "dyn_heap.h"
+
+// The heap never moves objects, it moves handles.
+// slots holds the objects, indexed by handle.
+// order is the heap itself: order[0] is the handle of the minimum.
+// position is the inverse of order: position[handle] is where handle sits in order.
+//
+// order is a permutation of every handle ever given out (0 .. high_water - 1).
+// The first size entries are live, the rest are free handles waiting to be reused,
+// so there's no separate free list to look after.
+// [3][0][2] | [1][4]
+//  live      free
+struct dyn_heap
+{
+	size_t capacity;
+	size_t size;
+	size_t high_water;
+	const size_t data_size;
+	void *slots;
+	size_t *order;
+	size_t *position;
+	int (*compare)(const void *, const void *);
+	void (*destructor)(void *);
+};
+
+// Same cap as dyn_array, we'll run out of memory before this happens anyway
+#ifndef DYN_MAX_CAPACITY
+#define DYN_MAX_CAPACITY (((size_t) 1) << ((sizeof(size_t) << 3) - 8))
+#endif
+
+// casts pointer and does arithmetic to get the object a handle names
+#define DYN_HEAP_SLOT(dyn_heap_ptr, handle) \
+	(((uint8_t *) (dyn_heap_ptr)->slots) + ((handle) * (dyn_heap_ptr)->data_size))
+// compares the objects at two heap positions
+#define DYN_HEAP_LESS(dyn_heap_ptr, a, b)                                            \
+	((dyn_heap_ptr)->compare(DYN_HEAP_SLOT(dyn_heap_ptr, (dyn_heap_ptr)->order[a]), \
+							 DYN_HEAP_SLOT(dyn_heap_ptr, (dyn_heap_ptr)->order[b])) < 0)
+
+
+// Grows all three arrays so one more handle can be given out
+static bool dyn_heap_request_handle(dyn_heap_t *const dyn_heap);
+
+// Moves the entry at position up/down until the heap property holds again
+static void dyn_heap_sift_up(dyn_heap_t *const dyn_heap, size_t position);
+static void dyn_heap_sift_down(dyn_heap_t *const dyn_heap, size_t position);
+
+// Swaps the handles at two heap positions
+static void dyn_heap_swap(dyn_heap_t *const dyn_heap, const size_t a, const size_t b);
+
+// Takes the minimum out of the live region, returns its (now free) handle
+static size_t dyn_heap_remove_min(dyn_heap_t *const dyn_heap);
+
+
+
+
+dyn_heap_t *dyn_heap_create(const size_t capacity, const size_t data_type_size,
+							int (*const compare)(const void *, const void *), void (*destruct_func)(void *))
+{
+	if (data_type_size && compare && capacity <= DYN_MAX_CAPACITY)
+	{
+		dyn_heap_t *dyn_heap = (dyn_heap_t *) malloc(sizeof(dyn_heap_t));
+		if (dyn_heap)
+		{
+			size_t actual_capacity = 16;
+			while (capacity > actual_capacity)
+			{
+				actual_capacity <<= 1;
+			}
+
+			// same const member trick as dyn_array_create
+			memcpy(dyn_heap, &((dyn_heap_t){actual_capacity, 0, 0, data_type_size,
+											malloc(data_type_size * actual_capacity),
+											malloc(sizeof(size_t) * actual_capacity),
+											malloc(sizeof(size_t) * actual_capacity), compare, destruct_func}),
+				   sizeof(dyn_heap_t));
+
+			if (dyn_heap->slots && dyn_heap->order && dyn_heap->position)
+			{
+				return dyn_heap;
+			}
+			free(dyn_heap->slots);
+			free(dyn_heap->order);
+			free(dyn_heap->position);
+			free(dyn_heap);
+		}
+	}
+	return NULL;
+}
+
+void dyn_heap_destroy(dyn_heap_t *const dyn_heap)
+{
+	if (dyn_heap)
+	{
+		dyn_heap_clear(dyn_heap);
+		free(dyn_heap->slots);
+		free(dyn_heap->order);
+		free(dyn_heap->position);
+		free(dyn_heap);
+	}
+}
+
+
+
+
+bool dyn_heap_push(dyn_heap_t *const dyn_heap, const void *const object, size_t *const handle)
+{
+	if (dyn_heap && object)
+	{
+		if (dyn_heap->size == dyn_heap->high_water)
+		{
+			// no free handle to recycle, mint a new one at the end of order
+			if (!dyn_heap_request_handle(dyn_heap))
+			{
+				return false;
+			}
+			dyn_heap->order[dyn_heap->high_water]	  = dyn_heap->high_water;
+			dyn_heap->position[dyn_heap->high_water] = dyn_heap->high_water;
+			++dyn_heap->high_water;
+		}
+
+		// the first free handle sits right after the live region
+		const size_t new_handle = dyn_heap->order[dyn_heap->size];
+		memcpy(DYN_HEAP_SLOT(dyn_heap, new_handle), object, dyn_heap->data_size);
+		dyn_heap_sift_up(dyn_heap, dyn_heap->size++);
+
+		if (handle)
+		{
+			*handle = new_handle;
+		}
+		return true;
+	}
+	return false;
+}
+
+void *dyn_heap_peek(const dyn_heap_t *const dyn_heap)
+{
+	if (dyn_heap && dyn_heap->size)
+	{
+		return DYN_HEAP_SLOT(dyn_heap, dyn_heap->order[0]);
+	}
+	return NULL;
+}
+
+bool dyn_heap_peek_handle(const dyn_heap_t *const dyn_heap, size_t *const handle)
+{
+	if (dyn_heap && dyn_heap->size && handle)
+	{
+		*handle = dyn_heap->order[0];
+		return true;
+	}
+	return false;
+}
+
+bool dyn_heap_pop(dyn_heap_t *const dyn_heap)
+{
+	if (dyn_heap && dyn_heap->size)
+	{
+		const size_t old_handle = dyn_heap_remove_min(dyn_heap);
+		if (dyn_heap->destructor)
+		{
+			dyn_heap->destructor(DYN_HEAP_SLOT(dyn_heap, old_handle));
+		}
+		return true;
+	}
+	return false;
+}
+
+bool dyn_heap_extract(dyn_heap_t *const dyn_heap, void *const object)
+{
+	if (dyn_heap && dyn_heap->size && object)
+	{
+		const size_t old_handle = dyn_heap_remove_min(dyn_heap);
+		memcpy(object, DYN_HEAP_SLOT(dyn_heap, old_handle), dyn_heap->data_size);
+		return true;
+	}
+	return false;
+}
+
+bool dyn_heap_extract_handle(dyn_heap_t *const dyn_heap, const size_t handle, void *const object)
+{
+	if (dyn_heap && object && handle < dyn_heap->high_water && dyn_heap->position[handle] < dyn_heap->size)
+	{
+		// fill the hole with the last live entry, which may belong above or below it
+		const size_t position = dyn_heap->position[handle];
+		dyn_heap_swap(dyn_heap, position, --dyn_heap->size);
+		if (position < dyn_heap->size)
+		{
+			const size_t moved = dyn_heap->order[position];
+			dyn_heap_sift_up(dyn_heap, position);
+			if (dyn_heap->position[moved] == position)
+			{
+				dyn_heap_sift_down(dyn_heap, position);
+			}
+		}
+		memcpy(object, DYN_HEAP_SLOT(dyn_heap, handle), dyn_heap->data_size);
+		return true;
+	}
+	return false;
+}
+
+bool dyn_heap_decrease_key(dyn_heap_t *const dyn_heap, const size_t handle, const void *const object)
+{
+	if (dyn_heap && object && handle < dyn_heap->high_water && dyn_heap->position[handle] < dyn_heap->size)
+	{
+		void *slot = DYN_HEAP_SLOT(dyn_heap, handle);
+		if (dyn_heap->compare(object, slot) > 0)
+		{
+			// that's an increase, which would need a sift down we don't promise
+			return false;
+		}
+		memcpy(slot, object, dyn_heap->data_size);
+		dyn_heap_sift_up(dyn_heap, dyn_heap->position[handle]);
+		return true;
+	}
+	return false;
+}
+
+void *dyn_heap_at(const dyn_heap_t *const dyn_heap, const size_t handle)
+{
+	if (dyn_heap && handle < dyn_heap->high_water && dyn_heap->position[handle] < dyn_heap->size)
+	{
+		return DYN_HEAP_SLOT(dyn_heap, handle);
+	}
+	return NULL;
+}
+
+
+
+
+void dyn_heap_clear(dyn_heap_t *const dyn_heap)
+{
+	if (dyn_heap)
+	{
+		if (dyn_heap->destructor)
+		{
+			for (size_t idx = 0; idx < dyn_heap->size; ++idx)
+			{
+				dyn_heap->destructor(DYN_HEAP_SLOT(dyn_heap, dyn_heap->order[idx]));
+			}
+		}
+		// every handle is free now, order is still a valid permutation
+		dyn_heap->size = 0;
+	}
+}
+
+bool dyn_heap_empty(const dyn_heap_t *const dyn_heap)
+{
+	return dyn_heap_size(dyn_heap) == 0;
+}
+
+size_t dyn_heap_size(const dyn_heap_t *const dyn_heap)
+{
+	if (dyn_heap)
+	{
+		return dyn_heap->size;
+	}
+	return 0;
+}
+
+size_t dyn_heap_data_size(const dyn_heap_t *const dyn_heap)
+{
+	if (dyn_heap)
+	{
+		return dyn_heap->data_size;
+	}
+	return 0;
+}
+
+
+
+
+static bool dyn_heap_request_handle(dyn_heap_t *const dyn_heap)
+{
+	if (dyn_heap->high_water < dyn_heap->capacity)
+	{
+		return true;
+	}
+	if (dyn_heap->capacity << 1 > DYN_MAX_CAPACITY)
+	{
+		return false;
+	}
+
+	const size_t new_capacity = dyn_heap->capacity << 1;
+
+	// grow one at a time, keeping whatever succeeded so a failure leaves the heap intact
+	void *new_slots = realloc(dyn_heap->slots, new_capacity * dyn_heap->data_size);
+	if (!new_slots)
+	{
+		return false;
+	}
+	dyn_heap->slots = new_slots;
+
+	size_t *new_order = (size_t *) realloc(dyn_heap->order, new_capacity * sizeof(size_t));
+	if (!new_order)
+	{
+		return false;
+	}
+	dyn_heap->order = new_order;
+
+	size_t *new_position = (size_t *) realloc(dyn_heap->position, new_capacity * sizeof(size_t));
+	if (!new_position)
+	{
+		return false;
+	}
+	dyn_heap->position = new_position;
+
+	dyn_heap->capacity = new_capacity;
+	return true;
+}
+
+static void dyn_heap_swap(dyn_heap_t *const dyn_heap, const size_t a, const size_t b)
+{
+	const size_t handle_a = dyn_heap->order[a];
+	dyn_heap->order[a]	  = dyn_heap->order[b];
+	dyn_heap->order[b]	  = handle_a;
+
+	dyn_heap->position[dyn_heap->order[a]] = a;
+	dyn_heap->position[dyn_heap->order[b]] = b;
+}
+
+static void dyn_heap_sift_up(dyn_heap_t *const dyn_heap, size_t position)
+{
+	while (position > 0)
+	{
+		const size_t parent = (position - 1) >> 1;
+		if (!DYN_HEAP_LESS(dyn_heap, position, parent))
+		{
+			break;
+		}
+		dyn_heap_swap(dyn_heap, position, parent);
+		position = parent;
+	}
+}
+
+static void dyn_heap_sift_down(dyn_heap_t *const dyn_heap, size_t position)
+{
+	for (;;)
+	{
+		size_t child = (position << 1) + 1;
+		if (child >= dyn_heap->size)
+		{
+			break;
+		}
+		if (child + 1 < dyn_heap->size && DYN_HEAP_LESS(dyn_heap, child + 1, child))
+		{
+			++child;
+		}
+		if (!DYN_HEAP_LESS(dyn_heap, child, position))
+		{
+			break;
+		}
+		dyn_heap_swap(dyn_heap, position, child);
+		position = child;
+	}
+}
+
+static size_t dyn_heap_remove_min(dyn_heap_t *const dyn_heap)
+{
+	// swapping the root with the last live entry parks the old root
+	// in the free region, exactly where push will look for it
+	const size_t old_handle = dyn_heap->order[0];
+	dyn_heap_swap(dyn_heap, 0, --dyn_heap->size);
+	dyn_heap_sift_down(dyn_heap, 0);
+	return old_handle;
+}
@@ -0,0 +1,302 @@
+#include "dyn_ring.h"
+
+// capacity is always a power of two so wrapping is just a mask
+// head is the slot of the front object, the back object is size - 1 slots after it
+// [D][E][?][?][A][B][C]
+//        ^tail  ^head
+struct dyn_ring
+{
+	size_t capacity;
+	size_t size;
+	size_t head;
+	const size_t data_size;
+	void *array;
+	void (*destructor)(void *);
+	dyn_allocator_t allocator;
+};
+
+// Same cap as dyn_array, we'll run out of memory before this happens anyway
+#ifndef DYN_MAX_CAPACITY
+#define DYN_MAX_CAPACITY (((size_t) 1) << ((sizeof(size_t) << 3) - 8))
+#endif
+
+// slot of the idx-th object counting from the front
+#define DYN_RING_SLOT(dyn_ring_ptr, idx) (((dyn_ring_ptr)->head + (idx)) & ((dyn_ring_ptr)->capacity - 1))
+// casts pointer and does arithmetic to get the address of a slot
+#define DYN_RING_POSITION(dyn_ring_ptr, slot) \
+	(((uint8_t *) (dyn_ring_ptr)->array) + ((slot) * (dyn_ring_ptr)->data_size))
+
+
+// Makes room for one more object, unwrapping the contents if the buffer has to grow
+static bool dyn_ring_request_size_increase(dyn_ring_t *const dyn_ring);
+
+// The allocator behind a NULL allocator, same as dyn_array's
+static void *dyn_ring_malloc(void *context, size_t size)
+{
+	(void) context;
+	return malloc(size);
+}
+
+static void *dyn_ring_realloc(void *context, void *ptr, size_t old_size, size_t new_size)
+{
+	(void) context;
+	(void) old_size;
+	return realloc(ptr, new_size);
+}
+
+static void dyn_ring_free(void *context, void *ptr, size_t size)
+{
+	(void) context;
+	(void) size;
+	free(ptr);
+}
+
+static const dyn_allocator_t DYN_RING_MALLOC_ALLOCATOR = {dyn_ring_malloc, dyn_ring_realloc, dyn_ring_free, NULL};
+
+
+
+
+dyn_ring_t *dyn_ring_create(const size_t capacity, const size_t data_type_size, void (*destruct_func)(void *))
+{
+	return dyn_ring_create_with_allocator(capacity, data_type_size, destruct_func, NULL);
+}
+
+dyn_ring_t *dyn_ring_create_with_allocator(const size_t capacity, const size_t data_type_size,
+										   void (*destruct_func)(void *), const dyn_allocator_t *const allocator)
+{
+	if (allocator && !(allocator->allocate && allocator->reallocate && allocator->release))
+	{
+		return NULL;
+	}
+	const dyn_allocator_t *const alloc = allocator ? allocator : &DYN_RING_MALLOC_ALLOCATOR;
+	if (data_type_size && capacity <= DYN_MAX_CAPACITY)
+	{
+		dyn_ring_t *dyn_ring = (dyn_ring_t *) alloc->allocate(alloc->context, sizeof(dyn_ring_t));
+		if (dyn_ring)
+		{
+			size_t actual_capacity = 16;
+			while (capacity > actual_capacity)
+			{
+				actual_capacity <<= 1;
+			}
+
+			// same const member trick as dyn_array_create
+			memcpy(dyn_ring, &((dyn_ring_t){actual_capacity, 0, 0, data_type_size,
+											alloc->allocate(alloc->context, data_type_size * actual_capacity),
+											destruct_func, *alloc}),
+				   sizeof(dyn_ring_t));
+
+			if (dyn_ring->array)
+			{
+				return dyn_ring;
+			}
+			alloc->release(alloc->context, dyn_ring, sizeof(dyn_ring_t));
+		}
+	}
+	return NULL;
+}
+
+void dyn_ring_destroy(dyn_ring_t *const dyn_ring)
+{
+	if (dyn_ring)
+	{
+		// copied out first, the allocator lives inside what it's releasing
+		const dyn_allocator_t allocator = dyn_ring->allocator;
+		dyn_ring_clear(dyn_ring);
+		allocator.release(allocator.context, dyn_ring->array, dyn_ring->capacity * dyn_ring->data_size);
+		allocator.release(allocator.context, dyn_ring, sizeof(dyn_ring_t));
+	}
+}
+
+
+
+
+void *dyn_ring_front(const dyn_ring_t *const dyn_ring)
+{
+	if (dyn_ring && dyn_ring->size)
+	{
+		return DYN_RING_POSITION(dyn_ring, dyn_ring->head);
+	}
+	return NULL;
+}
+
+bool dyn_ring_push_front(dyn_ring_t *const dyn_ring, const void *const object)
+{
+	if (dyn_ring && object && dyn_ring_request_size_increase(dyn_ring))
+	{
+		// step the head back one slot (wrapping) and fill it
+		dyn_ring->head = (dyn_ring->head - 1) & (dyn_ring->capacity - 1);
+		memcpy(DYN_RING_POSITION(dyn_ring, dyn_ring->head), object, dyn_ring->data_size);
+		++dyn_ring->size;
+		return true;
+	}
+	return false;
+}
+
+bool dyn_ring_pop_front(dyn_ring_t *const dyn_ring)
+{
+	if (dyn_ring && dyn_ring->size)
+	{
+		if (dyn_ring->destructor)
+		{
+			dyn_ring->destructor(DYN_RING_POSITION(dyn_ring, dyn_ring->head));
+		}
+		dyn_ring->head = DYN_RING_SLOT(dyn_ring, 1);
+		--dyn_ring->size;
+		return true;
+	}
+	return false;
+}
+
+bool dyn_ring_extract_front(dyn_ring_t *const dyn_ring, void *const object)
+{
+	if (dyn_ring && dyn_ring->size && object)
+	{
+		memcpy(object, DYN_RING_POSITION(dyn_ring, dyn_ring->head), dyn_ring->data_size);
+		dyn_ring->head = DYN_RING_SLOT(dyn_ring, 1);
+		--dyn_ring->size;
+		return true;
+	}
+	return false;
+}
+
+
+
+
+void *dyn_ring_back(const dyn_ring_t *const dyn_ring)
+{
+	if (dyn_ring && dyn_ring->size)
+	{
+		return DYN_RING_POSITION(dyn_ring, DYN_RING_SLOT(dyn_ring, dyn_ring->size - 1));
+	}
+	return NULL;
+}
+
+bool dyn_ring_push_back(dyn_ring_t *const dyn_ring, const void *const object)
+{
+	if (dyn_ring && object && dyn_ring_request_size_increase(dyn_ring))
+	{
+		memcpy(DYN_RING_POSITION(dyn_ring, DYN_RING_SLOT(dyn_ring, dyn_ring->size)), object, dyn_ring->data_size);
+		++dyn_ring->size;
+		return true;
+	}
+	return false;
+}
+
+bool dyn_ring_pop_back(dyn_ring_t *const dyn_ring)
+{
+	if (dyn_ring && dyn_ring->size)
+	{
+		--dyn_ring->size;
+		if (dyn_ring->destructor)
+		{
+			dyn_ring->destructor(DYN_RING_POSITION(dyn_ring, DYN_RING_SLOT(dyn_ring, dyn_ring->size)));
+		}
+		return true;
+	}
+	return false;
+}
+
+bool dyn_ring_extract_back(dyn_ring_t *const dyn_ring, void *const object)
+{
+	if (dyn_ring && dyn_ring->size && object)
+	{
+		--dyn_ring->size;
+		memcpy(object, DYN_RING_POSITION(dyn_ring, DYN_RING_SLOT(dyn_ring, dyn_ring->size)), dyn_ring->data_size);
+		return true;
+	}
+	return false;
+}
+
+
+void *dyn_ring_at(const dyn_ring_t *const dyn_ring, const size_t index)
+{
+	if (dyn_ring && index < dyn_ring->size)
+	{
+		return DYN_RING_POSITION(dyn_ring, DYN_RING_SLOT(dyn_ring, index));
+	}
+	return NULL;
+}
+
+void dyn_ring_clear(dyn_ring_t *const dyn_ring)
+{
+	if (dyn_ring)
+	{
+		if (dyn_ring->destructor)
+		{
+			for (size_t idx = 0; idx < dyn_ring->size; ++idx)
+			{
+				dyn_ring->destructor(DYN_RING_POSITION(dyn_ring, DYN_RING_SLOT(dyn_ring, idx)));
+			}
+		}
+		dyn_ring->size = 0;
+		dyn_ring->head = 0;
+	}
+}
+
+bool dyn_ring_empty(const dyn_ring_t *const dyn_ring)
+{
+	return dyn_ring_size(dyn_ring) == 0;
+}
+
+size_t dyn_ring_size(const dyn_ring_t *const dyn_ring)
+{
+	if (dyn_ring)
+	{
+		return dyn_ring->size;
+	}
+	return 0;
+}
+
+size_t dyn_ring_capacity(const dyn_ring_t *const dyn_ring)
+{
+	if (dyn_ring)
+	{
+		return dyn_ring->capacity;
+	}
+	return 0;
+}
+
+size_t dyn_ring_data_size(const dyn_ring_t *const dyn_ring)
+{
+	if (dyn_ring)
+	{
+		return dyn_ring->data_size;
+	}
+	return 0;
+}
+
+
+
+
+static bool dyn_ring_request_size_increase(dyn_ring_t *const dyn_ring)
+{
+	if (dyn_ring->size < dyn_ring->capacity)
+	{
+		return true;
+	}
+	if (dyn_ring->capacity << 1 > DYN_MAX_CAPACITY)
+	{
+		return false;
+	}
+
+	const size_t old_capacity = dyn_ring->capacity;
+	void *new_array			  = dyn_ring->allocator.reallocate(dyn_ring->allocator.context, dyn_ring->array,
+															   old_capacity * dyn_ring->data_size,
+															   (old_capacity << 1) * dyn_ring->data_size);
+	if (!new_array)
+	{
+		return false;
+	}
+	dyn_ring->array	   = new_array;
+	dyn_ring->capacity = old_capacity << 1;
+
+	// the ring is full, so if head isn't slot 0 the front part wrapped around
+	// copy the wrapped part to just after the old end, the new space is big enough for all of it
+	// [D][E][A][B][C] -> [x][x][A][B][C][D][E][?][?][?] (x is stale and gets overwritten later)
+	if (dyn_ring->head)
+	{
+		memcpy(DYN_RING_POSITION(dyn_ring, old_capacity), dyn_ring->array, dyn_ring->head * dyn_ring->data_size);
+	}
+	return true;
+}
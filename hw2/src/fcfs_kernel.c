@@ -0,0 +1,195 @@
+#include <stddef.h>
+
+#include "fcfs_kernel.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define FCFS_KERNEL_X86 1
+#include <immintrin.h>
+#else
+#define FCFS_KERNEL_X86 0
+#endif
+
+// jobs every kernel sums in 64 bits before carrying into the 128 bit totals, a multiple of every step
+#define FCFS_CHUNK 1024
+// 2^10 jobs of at most 2^32 starting before 2^52 all finish before 2^53, so a chunk sums to under 2^63
+#define FCFS_SAFE_FINISH (UINT64_C(1) << 52)
+
+// private function
+// the reference kernel, and the tail of the vector kernels
+// picks up from finish, the time the CPU frees up, and adds to the totals
+static void fcfs_scalar(const uint32_t *burst, const uint32_t *arrival, size_t count, uint64_t finish,
+						FcfsTotals_t *totals)
+{
+	// 64 bit sums a chunk at a time, folded into the 128 bit totals between chunks
+	// past FCFS_SAFE_FINISH each job is its own chunk, slow but no real trace gets there
+	ScheduleTotal_t turnaround = 0;
+	ScheduleTotal_t bursts     = 0;
+	for(size_t done = 0; done < count; )
+	{
+		size_t chunk = finish < FCFS_SAFE_FINISH ? FCFS_CHUNK : 1;
+		if(chunk > count - done)
+			chunk = count - done;
+
+		uint64_t chunk_turnaround = 0;
+		uint64_t chunk_bursts     = 0;
+		for(size_t i = done; i < done + chunk; i++)
+		{
+			uint64_t start = arrival[i] > finish ? arrival[i] : finish;
+			finish            = start + burst[i];
+			chunk_turnaround += finish - arrival[i];
+			chunk_bursts     += burst[i];
+		}
+		turnaround += chunk_turnaround;
+		bursts     += chunk_bursts;
+		done       += chunk;
+	}
+
+	// waiting = turnaround - burst for a job that runs without interruption
+	totals->total_waiting_time    += turnaround - bursts;
+	totals->total_turnaround_time += turnaround;
+	totals->total_run_time         = finish;
+}
+
+#if FCFS_KERNEL_X86
+
+// private function
+// eight lanes with a native 64 bit max, one block a step
+// each scan takes three steps, shifting by one, two and four lanes
+// picks up from totals->total_run_time like fcfs_scalar picks up from finish
+__attribute__((target("avx512f")))
+static void fcfs_avx512(const uint32_t *burst, const uint32_t *arrival, size_t count, FcfsTotals_t *totals)
+{
+	const __m512i shift1 = _mm512_set_epi64(6, 5, 4, 3, 2, 1, 0, 0);
+	const __m512i shift2 = _mm512_set_epi64(5, 4, 3, 2, 1, 0, 0, 0);
+	const __m512i shift4 = _mm512_set_epi64(3, 2, 1, 0, 0, 0, 0, 0);
+	const __m512i last   = _mm512_set1_epi64(7);
+	uint64_t last_finish       = totals->total_run_time;
+	__m512i carry_sum = _mm512_setzero_si512();			// B_{i-1} in every lane, counted from this call
+	__m512i carry_max = _mm512_set1_epi64(last_finish);	// max of arrival_j - B_{j-1} so far, starting from when the CPU frees up
+	__m512i finish    = _mm512_setzero_si512();
+	ScheduleTotal_t turnaround = 0;
+	uint64_t lanes[8];
+
+	// a chunk at a time, like fcfs_scalar, leaving anything past FCFS_SAFE_FINISH to it
+	size_t i = 0;
+	while(i + 8 <= count && last_finish < FCFS_SAFE_FINISH)
+	{
+		size_t chunk_end = count - i < FCFS_CHUNK ? count : i + FCFS_CHUNK;
+		__m512i turns = _mm512_setzero_si512();
+		for(; i + 8 <= chunk_end; i += 8)
+		{
+			__m512i b = _mm512_cvtepu32_epi64(_mm256_loadu_si256((const __m256i *)(burst + i)));
+			__m512i a = _mm512_cvtepu32_epi64(_mm256_loadu_si256((const __m256i *)(arrival + i)));
+
+			// the sum shifts in zeros through the mask, max is idempotent so it can shift in copies of lane 0
+			__m512i local_sum = _mm512_add_epi64(b, _mm512_maskz_permutexvar_epi64(0xFE, shift1, b));
+			local_sum = _mm512_add_epi64(local_sum, _mm512_maskz_permutexvar_epi64(0xFC, shift2, local_sum));
+			local_sum = _mm512_add_epi64(local_sum, _mm512_maskz_permutexvar_epi64(0xF0, shift4, local_sum));
+
+			__m512i local_max = _mm512_sub_epi64(a, _mm512_sub_epi64(local_sum, b));
+			local_max = _mm512_max_epi64(local_max, _mm512_permutexvar_epi64(shift1, local_max));
+			local_max = _mm512_max_epi64(local_max, _mm512_permutexvar_epi64(shift2, local_max));
+			local_max = _mm512_max_epi64(local_max, _mm512_permutexvar_epi64(shift4, local_max));
+
+			// arrival_j - B_{j-1} = (arrival_j - local B_{j-1}) - carried B
+			__m512i max = _mm512_max_epi64(_mm512_sub_epi64(local_max, carry_sum), carry_max);
+			finish   = _mm512_add_epi64(_mm512_add_epi64(local_sum, carry_sum), max);
+			turns    = _mm512_add_epi64(turns, _mm512_sub_epi64(finish, a));
+
+			carry_max = _mm512_permutexvar_epi64(last, max);
+			carry_sum = _mm512_add_epi64(carry_sum, _mm512_permutexvar_epi64(last, local_sum));
+		}
+
+		turnaround += (uint64_t)_mm512_reduce_add_epi64(turns);
+		_mm512_storeu_si512(lanes, finish);
+		last_finish = lanes[7];
+	}
+
+	_mm512_storeu_si512(lanes, carry_sum);
+	totals->total_waiting_time    += turnaround - lanes[0];
+	totals->total_turnaround_time += turnaround;
+
+	fcfs_scalar(burst + i, arrival + i, count - i, last_finish, totals);
+}
+
+#endif
+
+#if FCFS_KERNEL_X86
+
+// private function
+// the CPU can't change under a running process, so it is asked once and the answer kept,
+// racing threads can only both store the same answer
+static bool cpu_has_avx512(void)
+{
+	static int has_avx512 = -1;
+	int cached = __atomic_load_n(&has_avx512, __ATOMIC_RELAXED);
+	if(cached < 0)
+	{
+		__builtin_cpu_init();
+		cached = __builtin_cpu_supports("avx512f") ? 1 : 0;
+		__atomic_store_n(&has_avx512, cached, __ATOMIC_RELAXED);
+	}
+	return cached == 1;
+}
+
+#endif
+
+bool fcfs_kernel_supported(FcfsKernel_t kernel)
+{
+	switch(kernel)
+	{
+		case FCFS_KERNEL_SCALAR:
+			return true;
+#if FCFS_KERNEL_X86
+		case FCFS_KERNEL_AVX512:
+			return cpu_has_avx512();
+#endif
+		default:
+			return false;
+	}
+}
+
+// a vector kernel only goes in here once BM_FcfsKernel shows it beating scalar on the cores it targets
+// SSE4.2 and AVX2 don't: with no 64 bit max they emulate it with a compare and a blend (or and/andnot),
+// and that put them at 0.43-0.50G items/s against scalar's 0.60G, so they were dropped
+FcfsKernel_t fcfs_kernel_best(void)
+{
+	if(fcfs_kernel_supported(FCFS_KERNEL_AVX512))
+		return FCFS_KERNEL_AVX512;
+	return FCFS_KERNEL_SCALAR;
+}
+
+bool fcfs_kernel_resume(FcfsKernel_t kernel, const uint32_t *burst, const uint32_t *arrival, size_t count,
+						FcfsTotals_t *totals)
+{
+	if(totals == NULL || !fcfs_kernel_supported(kernel))
+		return false;
+	if(count == 0)
+		return true;
+	if(burst == NULL || arrival == NULL)
+		return false;
+
+	switch(kernel)
+	{
+#if FCFS_KERNEL_X86
+		case FCFS_KERNEL_AVX512:
+			fcfs_avx512(burst, arrival, count, totals);
+			break;
+#endif
+		default:
+			fcfs_scalar(burst, arrival, count, totals->total_run_time, totals);
+			break;
+	}
+	return true;
+}
+
+bool fcfs_kernel_run(FcfsKernel_t kernel, const PcbColumns_t *columns, FcfsTotals_t *totals)
+{
+	if(columns == NULL || totals == NULL)
+		return false;
+
+	totals->total_waiting_time    = 0;
+	totals->total_turnaround_time = 0;
+	totals->total_run_time        = 0;
+	return fcfs_kernel_resume(kernel, columns->burst, columns->arrival, columns->size, totals);
+}
@@ -0,0 +1,104 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pcb_generator.h"
+
+static void usage(const char *program)
+{
+	printf("%s <output file> <count> [options]\n", program);
+	printf("  --seed <n>                     random seed (default 1)\n");
+	printf("  --arrivals exponential|uniform|storm\n");
+	printf("  --arrival-mean <t>             mean time between arrivals (default 25)\n");
+	printf("  --storm-size <n>               mean jobs per storm (default 100)\n");
+	printf("  --bursts uniform|exponential|pareto\n");
+	printf("  --burst-mean <t>               mean burst time (default 20)\n");
+	printf("  --pareto-alpha <a>             Pareto shape, above 1 (default 1.5)\n");
+	printf("  --priorities <n>               number of priority levels (default 32)\n");
+}
+
+// Writes a synthetic PCB trace for load_process_control_blocks
+int main(int argc, char **argv)
+{
+	if(argc < 3)
+	{
+		usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	const char *output_file = argv[1];
+
+	unsigned long count = 0;
+	if(sscanf(argv[2], "%lu", &count) != 1 || count == 0 || count > UINT32_MAX)
+	{
+		fprintf(stderr, "Error: count must be a positive 32 bit integer.\n");
+		return EXIT_FAILURE;
+	}
+
+	PcbGeneratorConfig_t config;
+	pcb_generator_defaults(&config, (uint32_t)count, 1);
+
+	// every option takes exactly one value
+	for(int i = 3; i < argc; i += 2)
+	{
+		const char *option = argv[i];
+		const char *value  = i + 1 < argc ? argv[i + 1] : NULL;
+		bool ok = value != NULL;
+
+		if(ok && strcmp(option, "--seed") == 0)
+		{
+			unsigned long long seed;
+			ok = sscanf(value, "%llu", &seed) == 1;
+			config.seed = seed;
+		}
+		else if(ok && strcmp(option, "--arrivals") == 0)
+		{
+			if(strcmp(value, "exponential") == 0)
+				config.arrivals = ARRIVALS_EXPONENTIAL;
+			else if(strcmp(value, "uniform") == 0)
+				config.arrivals = ARRIVALS_UNIFORM;
+			else if(strcmp(value, "storm") == 0)
+				config.arrivals = ARRIVALS_STORM;
+			else
+				ok = false;
+		}
+		else if(ok && strcmp(option, "--arrival-mean") == 0)
+			ok = sscanf(value, "%lf", &config.arrival_mean) == 1;
+		else if(ok && strcmp(option, "--storm-size") == 0)
+			ok = sscanf(value, "%u", &config.storm_size) == 1;
+		else if(ok && strcmp(option, "--bursts") == 0)
+		{
+			if(strcmp(value, "uniform") == 0)
+				config.bursts = BURSTS_UNIFORM;
+			else if(strcmp(value, "exponential") == 0)
+				config.bursts = BURSTS_EXPONENTIAL;
+			else if(strcmp(value, "pareto") == 0)
+				config.bursts = BURSTS_PARETO;
+			else
+				ok = false;
+		}
+		else if(ok && strcmp(option, "--burst-mean") == 0)
+			ok = sscanf(value, "%lf", &config.burst_mean) == 1;
+		else if(ok && strcmp(option, "--pareto-alpha") == 0)
+			ok = sscanf(value, "%lf", &config.pareto_alpha) == 1;
+		else if(ok && strcmp(option, "--priorities") == 0)
+			ok = sscanf(value, "%u", &config.priority_levels) == 1;
+		else
+			ok = false;
+
+		if(!ok)
+		{
+			fprintf(stderr, "Error: bad option '%s'\n", option);
+			usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	if(!pcb_generate_file(output_file, &config))
+	{
+		fprintf(stderr, "Error: could not generate '%s' (check the options, disk space,"
+						" and that arrivals fit in 32 bits)\n", output_file);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
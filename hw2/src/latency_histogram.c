@@ -0,0 +1,95 @@
+#include <math.h>
+#include <stdlib.h>
+
+#include "latency_histogram.h"
+
+// values below 2^LINEAR_BITS are counted exactly
+#define LINEAR_BITS 8
+#define LINEAR_BUCKETS (1u << LINEAR_BITS)
+
+// above that, each power of two is split into this many buckets
+#define HALF_BUCKETS (LINEAR_BUCKETS / 2)
+
+// the top power of two, 2^63, ends at (63 - LINEAR_BITS + 1) * HALF_BUCKETS + LINEAR_BUCKETS - 1
+#define BUCKET_COUNT ((64 - LINEAR_BITS) * HALF_BUCKETS + LINEAR_BUCKETS)
+
+struct latency_histogram
+{
+	uint64_t count;
+	uint64_t max;
+	uint64_t buckets[BUCKET_COUNT];
+};
+
+// private function
+// the bucket a value falls in: the value itself below LINEAR_BUCKETS, otherwise the
+// top LINEAR_BITS bits of the value after dropping `shift` low bits, offset by shift
+static size_t bucket_of(uint64_t value)
+{
+	if(value < LINEAR_BUCKETS)
+		return (size_t)value;
+	unsigned shift = (unsigned)(63 - __builtin_clzll(value)) - (LINEAR_BITS - 1);
+	return (size_t)shift * HALF_BUCKETS + (size_t)(value >> shift);
+}
+
+// private function
+// the largest value that lands in bucket
+static uint64_t bucket_top(size_t bucket)
+{
+	if(bucket < LINEAR_BUCKETS)
+		return bucket;
+	unsigned shift = (unsigned)(bucket / HALF_BUCKETS) - 1;
+	uint64_t mantissa = bucket - (size_t)shift * HALF_BUCKETS;
+	return (mantissa << shift) + ((UINT64_C(1) << shift) - 1);
+}
+
+latency_histogram_t *latency_histogram_create(void)
+{
+	return calloc(1, sizeof(latency_histogram_t));
+}
+
+void latency_histogram_destroy(latency_histogram_t *histogram)
+{
+	free(histogram);
+}
+
+void latency_histogram_record(latency_histogram_t *histogram, uint64_t value)
+{
+	if(histogram == NULL)
+		return;
+	histogram->buckets[bucket_of(value)]++;
+	histogram->count++;
+	if(value > histogram->max)
+		histogram->max = value;
+}
+
+uint64_t latency_histogram_count(const latency_histogram_t *histogram)
+{
+	return histogram == NULL ? 0 : histogram->count;
+}
+
+uint64_t latency_histogram_max(const latency_histogram_t *histogram)
+{
+	return histogram == NULL ? 0 : histogram->max;
+}
+
+uint64_t latency_histogram_quantile(const latency_histogram_t *histogram, double quantile)
+{
+	if(histogram == NULL || histogram->count == 0)
+		return 0;
+
+	// nearest rank, at least the first value and at most the last
+	double wanted = ceil(quantile * (double)histogram->count);
+	uint64_t rank = wanted < 1.0 ? 1 : (wanted > (double)histogram->count ? histogram->count : (uint64_t)wanted);
+
+	uint64_t seen = 0;
+	for(size_t bucket = 0; bucket < BUCKET_COUNT; bucket++)
+	{
+		seen += histogram->buckets[bucket];
+		if(seen >= rank)
+		{
+			uint64_t top = bucket_top(bucket);
+			return top < histogram->max ? top : histogram->max;
+		}
+	}
+	return histogram->max;
+}
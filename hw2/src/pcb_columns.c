@@ -0,0 +1,66 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "pcb_columns.h"
+
+// every column starts on its own cache line, which is also wide enough for any SIMD load
+#define PCB_COLUMN_ALIGN 64
+
+// private function
+// bytes a column of count elements takes, rounded up to the alignment
+static size_t column_bytes(size_t count, size_t element_size)
+{
+	size_t bytes = count * element_size;
+	return (bytes + PCB_COLUMN_ALIGN - 1) & ~(size_t)(PCB_COLUMN_ALIGN - 1);
+}
+
+PcbColumns_t *pcb_columns_from_queue(const dyn_array_t *ready_queue)
+{
+	if(ready_queue == NULL || dyn_array_data_size(ready_queue) != sizeof(ProcessControlBlock_t))
+		return NULL;
+
+	size_t count = dyn_array_size(ready_queue);
+	if(count == 0)
+		return NULL;
+
+	PcbColumns_t *columns = malloc(sizeof(PcbColumns_t));
+	if(columns == NULL)
+		return NULL;
+
+	// one block for all four columns, so there is a single allocation to make and free
+	size_t u32_bytes  = column_bytes(count, sizeof(uint32_t));
+	size_t bool_bytes = column_bytes(count, sizeof(bool));
+	uint8_t *block = aligned_alloc(PCB_COLUMN_ALIGN, 3 * u32_bytes + bool_bytes);
+	if(block == NULL)
+	{
+		free(columns);
+		return NULL;
+	}
+
+	columns->burst    = (uint32_t *)block;
+	columns->priority = (uint32_t *)(block + u32_bytes);
+	columns->arrival  = (uint32_t *)(block + 2 * u32_bytes);
+	columns->started  = (bool *)(block + 3 * u32_bytes);
+	columns->size     = count;
+
+	// back of the queue is the first PCB, walk it backwards in one pass
+	const ProcessControlBlock_t *pcbs = (const ProcessControlBlock_t *)dyn_array_export(ready_queue);
+	for(size_t i = 0; i < count; i++)
+	{
+		const ProcessControlBlock_t *pcb = &pcbs[count - 1 - i];
+		columns->burst[i]    = pcb->remaining_burst_time;
+		columns->priority[i] = pcb->priority;
+		columns->arrival[i]  = pcb->arrival;
+		columns->started[i]  = pcb->started;
+	}
+	return columns;
+}
+
+void pcb_columns_destroy(PcbColumns_t *columns)
+{
+	if(columns == NULL)
+		return;
+	// burst is the start of the block
+	free(columns->burst);
+	free(columns);
+}
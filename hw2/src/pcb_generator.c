@@ -0,0 +1,166 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "pcb_generator.h"
+
+// records generated between writes, 4096 * 12 bytes
+#define PCB_GENERATOR_BLOCK 4096
+
+// within a storm jobs arrive this many times faster than the overall mean
+#define STORM_INTENSITY 20.0
+
+// private function
+// splitmix64, small and fast, and good enough for workload generation
+static uint64_t next_random(uint64_t *state)
+{
+	uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+// private function
+// uniform in [0, 1)
+static double next_unit(uint64_t *state)
+{
+	return (double)(next_random(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// private function
+// exponential with the given mean, by inverting the CDF
+static double next_exponential(uint64_t *state, double mean)
+{
+	return -mean * log(1.0 - next_unit(state));
+}
+
+// private function
+// the next gap between arrivals
+static double next_arrival_gap(uint64_t *state, const PcbGeneratorConfig_t *config, uint32_t *storm_left)
+{
+	switch(config->arrivals)
+	{
+		case ARRIVALS_UNIFORM:
+			return next_unit(state) * 2.0 * config->arrival_mean;
+		case ARRIVALS_STORM:
+		{
+			if(*storm_left > 0)
+			{
+				--*storm_left;
+				return next_exponential(state, config->arrival_mean / STORM_INTENSITY);
+			}
+			// storm over: a long quiet gap, then a new storm of geometric length
+			// the quiet gap makes up the time the storm saved, so the long run rate stays arrival_mean
+			double storm = (double)config->storm_size;
+			*storm_left = (uint32_t)floor(next_exponential(state, storm));
+			return next_exponential(state, config->arrival_mean * storm * (1.0 - 1.0 / STORM_INTENSITY));
+		}
+		case ARRIVALS_EXPONENTIAL:
+		default:
+			return next_exponential(state, config->arrival_mean);
+	}
+}
+
+// private function
+// the next burst time, at least 1 and clamped to 32 bits
+static uint32_t next_burst(uint64_t *state, const PcbGeneratorConfig_t *config)
+{
+	double burst;
+	switch(config->bursts)
+	{
+		case BURSTS_UNIFORM:
+			burst = 1.0 + floor(next_unit(state) * (2.0 * config->burst_mean - 1.0));
+			break;
+		case BURSTS_PARETO:
+		{
+			// scale chosen so the mean is burst_mean: mean = alpha * scale / (alpha - 1)
+			double scale = config->burst_mean * (config->pareto_alpha - 1.0) / config->pareto_alpha;
+			burst = scale / pow(1.0 - next_unit(state), 1.0 / config->pareto_alpha);
+			break;
+		}
+		case BURSTS_EXPONENTIAL:
+		default:
+			burst = ceil(next_exponential(state, config->burst_mean));
+			break;
+	}
+	if(burst < 1.0)
+		return 1;
+	if(burst > (double)UINT32_MAX)
+		return UINT32_MAX;
+	return (uint32_t)burst;
+}
+
+void pcb_generator_defaults(PcbGeneratorConfig_t *config, uint32_t count, uint64_t seed)
+{
+	if(config == NULL)
+		return;
+	config->count           = count;
+	config->seed            = seed;
+	config->arrivals        = ARRIVALS_EXPONENTIAL;
+	config->arrival_mean    = 25.0;
+	config->storm_size      = 100;
+	config->bursts          = BURSTS_UNIFORM;
+	config->burst_mean      = 20.0;
+	config->pareto_alpha    = 1.5;
+	config->priority_levels = 32;
+}
+
+bool pcb_generate(FILE *output, const PcbGeneratorConfig_t *config)
+{
+	// validate inputs
+	if(output == NULL || config == NULL || config->count == 0)
+		return false;
+	if(!(config->arrival_mean >= 0.0) || !(config->burst_mean >= 1.0) || config->priority_levels == 0)
+		return false;
+	if(config->arrivals == ARRIVALS_STORM && config->storm_size == 0)
+		return false;
+	if(config->bursts == BURSTS_PARETO && !(config->pareto_alpha > 1.0))
+		return false;
+
+	if(fwrite(&config->count, sizeof(uint32_t), 1, output) != 1)
+		return false;
+
+	uint64_t state      = config->seed;
+	uint32_t storm_left = 0;
+	double arrival      = 0.0;
+
+	uint32_t block[PCB_GENERATOR_BLOCK * 3];
+	uint32_t remaining = config->count;
+	while(remaining > 0)
+	{
+		uint32_t records = remaining < PCB_GENERATOR_BLOCK ? remaining : PCB_GENERATOR_BLOCK;
+		for(uint32_t i = 0; i < records; i++)
+		{
+			// the first job arrives at 0, the file is in arrival order
+			if(remaining != config->count || i != 0)
+				arrival += next_arrival_gap(&state, config, &storm_left);
+			if(arrival > (double)UINT32_MAX)
+				return false;
+
+			block[3 * i]     = next_burst(&state, config);
+			block[3 * i + 1] = (uint32_t)(next_random(&state) % config->priority_levels);
+			block[3 * i + 2] = (uint32_t)arrival;
+		}
+		if(fwrite(block, sizeof(uint32_t) * 3, records, output) != records)
+			return false;
+		remaining -= records;
+	}
+	return fflush(output) == 0;
+}
+
+bool pcb_generate_file(const char *path, const PcbGeneratorConfig_t *config)
+{
+	if(path == NULL)
+		return false;
+
+	FILE *output = fopen(path, "wb");
+	if(output == NULL)
+		return false;
+
+	bool success = pcb_generate(output, config);
+	if(fclose(output) != 0)
+		success = false;
+	if(!success)
+		remove(path);
+	return success;
+}
@@ -1,99 +1,707 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include <fcntl.h>
 #include <stdio.h>
 #include <string.h>
 #include <unistd.h>
 #include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "dyn_array.h"
+#include "dyn_heap.h"
+#include "dyn_ring.h"
+#include "fcfs_kernel.h"
 #include "processing_scheduling.h"
+#include "sim_engine.h"
+#include "smp_engine.h"
+
+// jobs the FCFS view gathers into burst and arrival columns on the stack at a time, 2 * 1024 * 4 bytes
+#define FCFS_VIEW_BLOCK 1024
 
 // private function
-void virtual_cpu(ProcessControlBlock_t *process_control_block) 
+// copies the PCB dispatched i-th out of view, the back of the queue is dispatched first
+static void fcfs_view_pcb(const PcbView_t *view, size_t i, ProcessControlBlock_t *pcb)
 {
-	// decrement the burst time of the pcb
-	--process_control_block->remaining_burst_time;
+	// the stride may leave a PCB unaligned, so it is copied rather than dereferenced
+	memcpy(pcb, (const uint8_t *)view->base + (view->count - 1 - i) * view->stride, sizeof(ProcessControlBlock_t));
+}
+
+// private function
+// the closed form one job at a time, handing each run to the recorder as it goes
+static bool fcfs_recorded_pass(const PcbView_t *view, SimRecorder_t *recorder, FcfsTotals_t *totals)
+{
+	uint64_t finish = 0;
+	for(size_t i = 0; i < view->count; i++)
+	{
+		ProcessControlBlock_t pcb;
+		fcfs_view_pcb(view, i, &pcb);
+		uint64_t start = pcb.arrival > finish ? pcb.arrival : finish;
+		finish = start + pcb.remaining_burst_time;
+
+		SimJob_t job;
+		job.pid         = i;
+		job.burst       = pcb.remaining_burst_time;
+		job.level       = 0;
+		job.pcb         = pcb;
+		job.pcb.started = false;
+		if(!sim_recorder_slice(recorder, &job, start, finish))
+			return false;
+		sim_recorder_complete(recorder, &job, finish);
+		totals->total_waiting_time    += start - pcb.arrival;
+		totals->total_turnaround_time += finish - pcb.arrival;
+	}
+	totals->total_run_time = finish;
+	return true;
+}
+
+// private function
+// the closed form kernel over the view a block at a time, so a run holds one block of columns whatever the trace size
+static bool fcfs_kernel_pass(const PcbView_t *view, FcfsTotals_t *totals)
+{
+	_Alignas(64) uint32_t burst[FCFS_VIEW_BLOCK];
+	_Alignas(64) uint32_t arrival[FCFS_VIEW_BLOCK];
+	FcfsKernel_t kernel = fcfs_kernel_best();
+	for(size_t i = 0; i < view->count; )
+	{
+		size_t count = 0;
+		for(; i < view->count && count < FCFS_VIEW_BLOCK; i++, count++)
+		{
+			ProcessControlBlock_t pcb;
+			fcfs_view_pcb(view, i, &pcb);
+			burst[count]   = pcb.remaining_burst_time;
+			arrival[count] = pcb.arrival;
+		}
+		if(!fcfs_kernel_resume(kernel, burst, arrival, count, totals))
+			return false;
+	}
+	return true;
+}
+
+bool pcb_view_from_queue(PcbView_t *view, const dyn_array_t *ready_queue)
+{
+	if(view == NULL || ready_queue == NULL || dyn_array_data_size(ready_queue) != sizeof(ProcessControlBlock_t))
+		return false;
+	view->base   = dyn_array_export(ready_queue);
+	view->count  = dyn_array_size(ready_queue);
+	view->stride = sizeof(ProcessControlBlock_t);
+	return view->count > 0;
+}
+
+bool first_come_first_serve_view(const PcbView_t *view, ScheduleResult_t *result, const ScheduleOutputs_t *outputs)
+{
+	// validate inputs
+	if(view == NULL || result == NULL)
+		return false;
+
+	// process each PCB in queue order (back of queue = first arrived)
+	// no sorting: a job that arrives later than the one behind it simply leaves the CPU idle
+	// with a fixed order there is nothing to simulate, the closed form kernel gives the totals in one pass
+	if(view->base == NULL || view->count == 0 || view->stride < sizeof(ProcessControlBlock_t))
+		return false;
+
+	SimRecorder_t recorder;
+	if(!sim_recorder_init(&recorder, outputs))
+		return false;
+
+	// the kernel has no per-job events, so anything recorded goes through the scalar pass
+	FcfsTotals_t fcfs = { 0, 0, 0 };
+	bool success = sim_recorder_active(&recorder) ? fcfs_recorded_pass(view, &recorder, &fcfs)
+												  : fcfs_kernel_pass(view, &fcfs);
+
+	// every job runs once without interruption, so its response is its waiting time
+	SimTotals_t totals;
+	totals.response_time   = fcfs.total_waiting_time;
+	totals.turnaround_time = fcfs.total_turnaround_time;
+	totals.burst_time      = fcfs.total_turnaround_time - fcfs.total_waiting_time;
+	totals.num_processes   = view->count;
+	totals.run_time        = fcfs.total_run_time;
+	sim_recorder_finish(&recorder, success ? &totals : NULL);
+	if(!success)
+		return false;
+
+	sim_result_from_totals(result, &totals);
+	return true;
+}
+
+bool first_come_first_serve_detailed(dyn_array_t *ready_queue, ScheduleResult_t *result,
+									 const ScheduleOutputs_t *outputs)
+{
+	PcbView_t view;
+	if(!pcb_view_from_queue(&view, ready_queue) || !first_come_first_serve_view(&view, result, outputs))
+		return false;
+	// like the other schedulers, the queue is used up by the run, and its peak capacity is given back
+	dyn_array_clear(ready_queue);
+	dyn_array_shrink_to_fit(ready_queue);
+	return true;
 }
 
 bool first_come_first_serve(dyn_array_t *ready_queue, ScheduleResult_t *result) 
+{
+	return first_come_first_serve_detailed(ready_queue, result, NULL);
+}
+
+// SJF ready set
+// dyn_heap of jobs keyed on remaining burst time, arrival time and then pid break ties
+static int compare_shortest_burst(const void *a, const void *b)
+{
+	const SimJob_t *lhs = (const SimJob_t *)a;
+	const SimJob_t *rhs = (const SimJob_t *)b;
+	if(lhs->pcb.remaining_burst_time != rhs->pcb.remaining_burst_time)
+		return lhs->pcb.remaining_burst_time < rhs->pcb.remaining_burst_time ? -1 : 1;
+	if(lhs->pcb.arrival != rhs->pcb.arrival)
+		return lhs->pcb.arrival < rhs->pcb.arrival ? -1 : 1;
+	if(lhs->pid != rhs->pid)
+		return lhs->pid < rhs->pid ? -1 : 1;
+	return 0;
+}
+
+static bool job_heap_admit(void *ready_set, const SimJob_t *job)
+{
+	return dyn_heap_push((dyn_heap_t *)ready_set, job, NULL);
+}
+
+static bool job_heap_select(void *ready_set, SimJob_t *job)
+{
+	return dyn_heap_extract((dyn_heap_t *)ready_set, job);
+}
+
+static bool job_heap_requeue(void *ready_set, const SimJob_t *job)
+{
+	// SJF is non-preemptive, so nothing should ever come back
+	(void)(ready_set);
+	(void)(job);
+	return false;
+}
+
+// private function
+// runs the jobs from feed non-preemptively, shortest burst first
+static bool job_heap_schedule(const SimFeed_t *feed, size_t capacity, const ScheduleOutputs_t *outputs,
+								  ScheduleResult_t *result)
+{
+	dyn_heap_t *heap = dyn_heap_create(capacity, sizeof(SimJob_t), compare_shortest_burst, NULL);
+	if(heap == NULL)
+		return false;
+	SimPolicy_t policy = { job_heap_admit, job_heap_select, job_heap_requeue, NULL, heap, 0, false, NULL, NULL, NULL };
+
+	bool success = sim_run_feed(feed, &policy, outputs, result);
+	dyn_heap_destroy(heap);
+	return success;
+}
+
+bool shortest_job_first_view(const PcbView_t *view, ScheduleResult_t *result, const ScheduleOutputs_t *outputs)
 {
 	// validate inputs
-	if(ready_queue == NULL || result == NULL)
+	if(view == NULL || result == NULL)
 		return false;
 
-	size_t num_processes = dyn_array_size(ready_queue);
-	if(num_processes == 0)
+	// admit processes in arrival order as the clock reaches them, the heap never holds more than all of them
+	SimFeed_t feed;
+	SimViewCursor_t cursor;
+	if(!sim_feed_from_view(&feed, &cursor, view, true))
+		return false;
+
+	bool success = job_heap_schedule(&feed, view->count, outputs, result);
+	sim_view_cursor_release(&cursor);
+	return success;
+}
+
+bool shortest_job_first_detailed(dyn_array_t *ready_queue, ScheduleResult_t *result, const ScheduleOutputs_t *outputs)
+{
+	PcbView_t view;
+	if(!pcb_view_from_queue(&view, ready_queue) || !shortest_job_first_view(&view, result, outputs))
 		return false;
+	// like the other schedulers, the queue is used up by the run, and its peak capacity is given back
+	dyn_array_clear(ready_queue);
+	dyn_array_shrink_to_fit(ready_queue);
+	return true;
+}
+
+bool shortest_job_first(dyn_array_t *ready_queue, ScheduleResult_t *result) 
+{
+	return shortest_job_first_detailed(ready_queue, result, NULL);
+}
+
+// Priority ready set
+// dyn_heap of jobs, lower priority values first, ages folded into keys that never change while a job waits
+// a job that joined the ready set at t has effective priority priority - (now - t) / aging_interval, so
+// ordering on priority * aging_interval + t orders on effective priority at every instant, without rescans
+typedef struct
+{
+	ScheduleTotal_t key;	// priority, or priority * aging_interval + when the job last joined the ready set
+	SimJob_t job;
+} PriorityEntry_t;
+
+typedef struct
+{
+	dyn_heap_t *heap;
+	uint64_t aging_interval;	// 0 for no aging
+	uint64_t now;				// time of the coming select
+	size_t running;				// handle of the job last selected, it stays in the heap while it runs
+	bool requeued;				// the job last selected ran a slice and has not completed
+} PriorityHeap_t;
+
+static int compare_priority_key(const void *a, const void *b)
+{
+	const PriorityEntry_t *lhs = (const PriorityEntry_t *)a;
+	const PriorityEntry_t *rhs = (const PriorityEntry_t *)b;
+	if(lhs->key != rhs->key)
+		return lhs->key < rhs->key ? -1 : 1;
+	if(lhs->job.pcb.arrival != rhs->job.pcb.arrival)
+		return lhs->job.pcb.arrival < rhs->job.pcb.arrival ? -1 : 1;
+	if(lhs->job.pid != rhs->job.pid)
+		return lhs->job.pid < rhs->job.pid ? -1 : 1;
+	return 0;
+}
 
-	// initialize result fields
-	result->average_waiting_time    = 0.0f;
-	result->average_turnaround_time = 0.0f;
-	result->total_run_time          = 0;
+// private function
+// the key of a job with the given priority that joined the ready set at joined
+static ScheduleTotal_t priority_key(const PriorityHeap_t *ready, uint32_t priority, uint64_t joined)
+{
+	if(ready->aging_interval == 0)
+		return priority;
+	return (ScheduleTotal_t)priority * ready->aging_interval + joined;
+}
 
-	float total_waiting_time    = 0.0f;
-	float total_turnaround_time = 0.0f;
-	unsigned long current_time  = 0;
+static bool priority_heap_admit(void *ready_set, const SimJob_t *job)
+{
+	PriorityHeap_t *ready = (PriorityHeap_t *)ready_set;
+	PriorityEntry_t entry;
+	entry.key = priority_key(ready, job->pcb.priority, job->pcb.arrival);
+	entry.job = *job;
+	return dyn_heap_push(ready->heap, &entry, NULL);
+}
+
+static bool priority_heap_select(void *ready_set, SimJob_t *job)
+{
+	PriorityHeap_t *ready = (PriorityHeap_t *)ready_set;
+	size_t top;
+	if(!dyn_heap_peek_handle(ready->heap, &top))
+		return false;
 
-	// process each PCB in arrival order (back of queue = first arrived)
-	for(size_t i = 0; i < num_processes; i++)
+	if(ready->requeued && top != ready->running)
 	{
-		ProcessControlBlock_t pcb;
-		if(!dyn_array_extract_back(ready_queue, &pcb))
+		// the job that just ran was preempted, its wait starts over now
+		// its key only goes up, so whatever is on top stays there
+		PriorityEntry_t preempted;
+		if(!dyn_heap_extract_handle(ready->heap, ready->running, &preempted))
+			return false;
+		preempted.key = priority_key(ready, preempted.job.pcb.priority, ready->now);
+		if(!dyn_heap_push(ready->heap, &preempted, NULL))
+			return false;
+	}
+
+	ready->requeued = false;
+	ready->running  = top;
+	*job = ((const PriorityEntry_t *)dyn_heap_at(ready->heap, top))->job;
+	return true;
+}
+
+static bool priority_heap_requeue(void *ready_set, const SimJob_t *job)
+{
+	// only the remaining time changed, which the key does not depend on, so nothing moves
+	PriorityHeap_t *ready = (PriorityHeap_t *)ready_set;
+	PriorityEntry_t *entry = (PriorityEntry_t *)dyn_heap_at(ready->heap, ready->running);
+	if(entry == NULL)
+		return false;
+	entry->job      = *job;
+	ready->requeued = true;
+	return true;
+}
+
+static bool priority_heap_retire(void *ready_set, const SimJob_t *job)
+{
+	(void)(job);
+	PriorityHeap_t *ready = (PriorityHeap_t *)ready_set;
+	PriorityEntry_t finished;
+	ready->requeued = false;
+	return dyn_heap_extract_handle(ready->heap, ready->running, &finished);
+}
+
+static bool priority_heap_age(void *ready_set, uint64_t now)
+{
+	((PriorityHeap_t *)ready_set)->now = now;
+	return true;
+}
+
+// private function
+// runs the jobs from feed by priority, preempting on arrivals if config asks for it
+static bool priority_schedule(const SimFeed_t *feed, size_t capacity, const PriorityConfig_t *config,
+							  const ScheduleOutputs_t *outputs, ScheduleResult_t *result)
+{
+	PriorityHeap_t ready = { dyn_heap_create(capacity, sizeof(PriorityEntry_t), compare_priority_key, NULL),
+							 config->aging_interval, 0, 0, false };
+	if(ready.heap == NULL)
+		return false;
+
+	// keys only change when a job is preempted, so an arrival is the only time the order can change
+	SimPolicy_t policy = { priority_heap_admit, priority_heap_select, priority_heap_requeue, priority_heap_retire,
+						   &ready, 0, config->preemptive, NULL, priority_heap_age, NULL };
+
+	bool success = sim_run_feed(feed, &policy, outputs, result);
+	dyn_heap_destroy(ready.heap);
+	return success;
+}
+
+bool priority_view(const PcbView_t *view, ScheduleResult_t *result, const PriorityConfig_t *config,
+				   const ScheduleOutputs_t *outputs)
+{
+	// validate inputs
+	if(view == NULL || result == NULL || config == NULL)
+		return false;
+
+	SimFeed_t feed;
+	SimViewCursor_t cursor;
+	if(!sim_feed_from_view(&feed, &cursor, view, true))
+		return false;
+
+	bool success = priority_schedule(&feed, view->count, config, outputs, result);
+	sim_view_cursor_release(&cursor);
+	return success;
+}
+
+bool priority_detailed(dyn_array_t *ready_queue, ScheduleResult_t *result, const PriorityConfig_t *config,
+					   const ScheduleOutputs_t *outputs)
+{
+	PcbView_t view;
+	if(!pcb_view_from_queue(&view, ready_queue) || !priority_view(&view, result, config, outputs))
+		return false;
+	// like the other schedulers, the queue is used up by the run, and its peak capacity is given back
+	dyn_array_clear(ready_queue);
+	dyn_array_shrink_to_fit(ready_queue);
+	return true;
+}
+
+bool priority(dyn_array_t *ready_queue, ScheduleResult_t *result) 
+{
+	const PriorityConfig_t config = { false, 0 };
+	return priority_detailed(ready_queue, result, &config, NULL);
+}
+
+// RR ready set
+// dyn_ring run queue, so putting a sliced job back costs O(1) instead of a memmove
+static bool run_queue_admit(void *ready_set, const SimJob_t *job)
+{
+	return dyn_ring_push_back((dyn_ring_t *)ready_set, job);
+}
+
+static bool run_queue_select(void *ready_set, SimJob_t *job)
+{
+	return dyn_ring_extract_front((dyn_ring_t *)ready_set, job);
+}
+
+// private function
+// runs the jobs from feed through a run queue, to completion when quantum is 0
+// each slice advances the clock by min(quantum, remaining) in one step
+// jobs arriving during a slice are queued ahead of the job it preempted
+static bool run_queue_schedule(const SimFeed_t *feed, size_t capacity, size_t quantum, const ScheduleOutputs_t *outputs,
+								  ScheduleResult_t *result)
+{
+	dyn_ring_t *run_queue = dyn_ring_create_with_allocator(capacity, sizeof(SimJob_t), NULL, sim_scratch_allocator());
+	if(run_queue == NULL)
+		return false;
+	SimPolicy_t policy = { run_queue_admit, run_queue_select, run_queue_admit, NULL, run_queue, quantum, false,
+						   NULL, NULL, NULL };
+
+	bool success = sim_run_feed(feed, &policy, outputs, result);
+	dyn_ring_destroy(run_queue);
+	return success;
+}
+
+bool round_robin_view(const PcbView_t *view, ScheduleResult_t *result, size_t quantum,
+					  const ScheduleOutputs_t *outputs)
+{
+	// validate inputs
+	if(view == NULL || result == NULL || quantum == 0)
+		return false;
+
+	SimFeed_t feed;
+	SimViewCursor_t cursor;
+	if(!sim_feed_from_view(&feed, &cursor, view, true))
+		return false;
+
+	bool success = run_queue_schedule(&feed, view->count, quantum, outputs, result);
+	sim_view_cursor_release(&cursor);
+	return success;
+}
+
+bool round_robin_detailed(dyn_array_t *ready_queue, ScheduleResult_t *result, size_t quantum,
+						  const ScheduleOutputs_t *outputs)
+{
+	PcbView_t view;
+	if(!pcb_view_from_queue(&view, ready_queue) || !round_robin_view(&view, result, quantum, outputs))
+		return false;
+	// like the other schedulers, the queue is used up by the run, and its peak capacity is given back
+	dyn_array_clear(ready_queue);
+	dyn_array_shrink_to_fit(ready_queue);
+	return true;
+}
+
+bool round_robin(dyn_array_t *ready_queue, ScheduleResult_t *result, size_t quantum) 
+{
+	return round_robin_detailed(ready_queue, result, quantum, NULL);
+}
+
+// MLFQ ready set
+// one dyn_ring per level and a bit per level with jobs waiting, so select finds the top one in O(1)
+// only a job an arrival cut short goes back to the front of a level, and nothing can run from that level
+// before it, so each level holds at most one part used quantum, and it belongs to the job at its front
+typedef struct
+{
+	dyn_ring_t *levels[MLFQ_MAX_LEVELS];
+	size_t quanta[MLFQ_MAX_LEVELS];
+	size_t used[MLFQ_MAX_LEVELS];	// quantum already used by the job at the front of each level, 0 for a fresh one
+	size_t num_levels;
+	uint64_t occupied;			// bit i is set while level i has jobs waiting
+	uint64_t boost_interval;	// 0 for never
+	uint64_t next_boost;		// when the next boost is due
+	uint32_t dispatched_burst;	// remaining burst of the job select last returned, to tell a cut slice on requeue
+	size_t dispatched_used;		// quantum that job had used on its level before this slice
+} FeedbackQueues_t;
+
+// private function
+static bool feedback_push(FeedbackQueues_t *queues, const SimJob_t *job)
+{
+	if(!dyn_ring_push_back(queues->levels[job->level], job))
+		return false;
+	queues->occupied |= UINT64_C(1) << job->level;
+	return true;
+}
+
+static bool feedback_admit(void *ready_set, const SimJob_t *job)
+{
+	// every job starts at the top level
+	SimJob_t arrived = *job;
+	arrived.level = 0;
+	return feedback_push((FeedbackQueues_t *)ready_set, &arrived);
+}
+
+static bool feedback_select(void *ready_set, SimJob_t *job)
+{
+	FeedbackQueues_t *queues = (FeedbackQueues_t *)ready_set;
+	if(queues->occupied == 0)
+		return false;
+	unsigned level = (unsigned)__builtin_ctzll(queues->occupied);
+	if(!dyn_ring_extract_front(queues->levels[level], job))
+		return false;
+	if(dyn_ring_empty(queues->levels[level]))
+		queues->occupied &= ~(UINT64_C(1) << level);
+	queues->dispatched_burst = job->pcb.remaining_burst_time;
+	queues->dispatched_used  = queues->used[level];
+	queues->used[level]      = 0;
+	return true;
+}
+
+static bool feedback_requeue(void *ready_set, const SimJob_t *job)
+{
+	FeedbackQueues_t *queues = (FeedbackQueues_t *)ready_set;
+
+	// a job cut short by an arrival keeps its level and goes first in it, with what is left of its quantum,
+	// so however often arrivals cut it, it sinks once it has run a whole quantum on the level
+	size_t used = queues->dispatched_used + (queues->dispatched_burst - job->pcb.remaining_burst_time);
+	if(used < queues->quanta[job->level])
+	{
+		if(!dyn_ring_push_front(queues->levels[job->level], job))
 			return false;
+		queues->used[job->level] = used;
+		queues->occupied |= UINT64_C(1) << job->level;
+		return true;
+	}
+
+	// otherwise it used its whole quantum and sinks a level
+	SimJob_t demoted = *job;
+	if(demoted.level + 1 < queues->num_levels)
+		demoted.level++;
+	return feedback_push(queues, &demoted);
+}
+
+static size_t feedback_quantum_of(void *ready_set, const SimJob_t *job)
+{
+	const FeedbackQueues_t *queues = (const FeedbackQueues_t *)ready_set;
+	return queues->quanta[job->level] - queues->dispatched_used;
+}
 
-		// if CPU is idle before process arrives, advance time
-		if(current_time < (unsigned long)pcb.arrival)
-			current_time = (unsigned long)pcb.arrival;
+static bool feedback_preempt_on_arrival_of(void *ready_set, const SimJob_t *job)
+{
+	// arrivals enter at the top level, so they only outrank a job that has sunk below it
+	(void)ready_set;
+	return job->level > 0;
+}
 
-		// waiting time = start time - arrival time
-		float waiting_time = (float)(current_time - pcb.arrival);
-		total_waiting_time += waiting_time;
+static bool feedback_age(void *ready_set, uint64_t now)
+{
+	FeedbackQueues_t *queues = (FeedbackQueues_t *)ready_set;
+	if(queues->boost_interval == 0 || now < queues->next_boost)
+		return true;
 
-		// run the process to completion
-		while(pcb.remaining_burst_time > 0)
+	// boosts happen lazily at the first select past a boundary, however many boundaries went by
+	queues->next_boost = (now / queues->boost_interval + 1) * queues->boost_interval;
+
+	// every waiting job goes back to the top on a fresh quantum, higher levels ahead of lower ones
+	while((queues->occupied & ~UINT64_C(1)) != 0)
+	{
+		unsigned level = (unsigned)__builtin_ctzll(queues->occupied & ~UINT64_C(1));
+		SimJob_t job;
+		while(dyn_ring_extract_front(queues->levels[level], &job))
 		{
-			virtual_cpu(&pcb);
-			current_time++;
+			job.level = 0;
+			if(!feedback_push(queues, &job))
+				return false;
 		}
+		queues->used[level]  = 0;
+		queues->occupied    &= ~(UINT64_C(1) << level);
+	}
+	return true;
+}
+
+// private function
+static bool mlfq_config_valid(const MlfqConfig_t *config)
+{
+	if(config == NULL || config->quanta == NULL)
+		return false;
+	if(config->num_levels == 0 || config->num_levels > MLFQ_MAX_LEVELS)
+		return false;
+	for(size_t level = 0; level < config->num_levels; level++)
+	{
+		if(config->quanta[level] == 0)
+			return false;
+	}
+	return true;
+}
+
+// private function
+// runs the jobs from feed through the levels of config, each level round robin with its own quantum
+static bool feedback_schedule(const SimFeed_t *feed, size_t capacity, const MlfqConfig_t *config,
+							  const ScheduleOutputs_t *outputs, ScheduleResult_t *result)
+{
+	FeedbackQueues_t queues;
+	queues.num_levels       = config->num_levels;
+	queues.occupied         = 0;
+	queues.boost_interval   = config->boost_interval;
+	queues.next_boost       = config->boost_interval;
+	queues.dispatched_burst = 0;
+	queues.dispatched_used  = 0;
 
-		// turnaround time = completion time - arrival time
-		float turnaround_time = (float)(current_time - pcb.arrival);
-		total_turnaround_time += turnaround_time;
+	// jobs spread over the levels as they sink, the rings grow if many end up on one
+	bool success = true;
+	for(size_t level = 0; level < queues.num_levels; level++)
+	{
+		queues.quanta[level] = config->quanta[level];
+		queues.used[level]   = 0;
+		queues.levels[level] = dyn_ring_create_with_allocator(capacity / queues.num_levels + 1, sizeof(SimJob_t), NULL,
+															  sim_scratch_allocator());
+		success = success && queues.levels[level] != NULL;
 	}
 
-	result->total_run_time          = current_time;
-	result->average_waiting_time    = total_waiting_time    / (float)num_processes;
-	result->average_turnaround_time = total_turnaround_time / (float)num_processes;
+	SimPolicy_t policy = { feedback_admit, feedback_select, feedback_requeue, NULL, &queues, 0, false,
+						   feedback_quantum_of, feedback_age, feedback_preempt_on_arrival_of };
+	success = success && sim_run_feed(feed, &policy, outputs, result);
+
+	for(size_t level = 0; level < queues.num_levels; level++)
+		dyn_ring_destroy(queues.levels[level]);
+	return success;
+}
+
+bool multilevel_feedback_queue_view(const PcbView_t *view, ScheduleResult_t *result, const MlfqConfig_t *config,
+								 const ScheduleOutputs_t *outputs)
+{
+	// validate inputs
+	if(view == NULL || result == NULL || !mlfq_config_valid(config))
+		return false;
+
+	SimFeed_t feed;
+	SimViewCursor_t cursor;
+	if(!sim_feed_from_view(&feed, &cursor, view, true))
+		return false;
 
+	bool success = feedback_schedule(&feed, view->count, config, outputs, result);
+	sim_view_cursor_release(&cursor);
+	return success;
+}
+
+bool multilevel_feedback_queue_detailed(dyn_array_t *ready_queue, ScheduleResult_t *result,
+										const MlfqConfig_t *config, const ScheduleOutputs_t *outputs)
+{
+	PcbView_t view;
+	if(!pcb_view_from_queue(&view, ready_queue) || !multilevel_feedback_queue_view(&view, result, config, outputs))
+		return false;
+	// like the other schedulers, the queue is used up by the run, and its peak capacity is given back
+	dyn_array_clear(ready_queue);
+	dyn_array_shrink_to_fit(ready_queue);
 	return true;
 }
 
-bool shortest_job_first(dyn_array_t *ready_queue, ScheduleResult_t *result) 
+bool multilevel_feedback_queue(dyn_array_t *ready_queue, ScheduleResult_t *result, const MlfqConfig_t *config)
 {
-	(void)(ready_queue);
-	(void)(result);
-	return false;
+	return multilevel_feedback_queue_detailed(ready_queue, result, config, NULL);
 }
 
-bool priority(dyn_array_t *ready_queue, ScheduleResult_t *result) 
+// layout of the PCB file: a uint32_t count followed by count (burst, priority, arrival) uint32_t triples
+#define PCB_FILE_HEADER_SIZE sizeof(uint32_t)
+#define PCB_FILE_RECORD_SIZE (3 * sizeof(uint32_t))
+
+// private function
+// keeps calling read until len bytes arrived, false on error or early end of file
+static bool read_fully(int fd, void *buffer, size_t len)
 {
-	(void)(ready_queue);
-	(void)(result);
-	return false;
+	uint8_t *walker = (uint8_t *)buffer;
+	while(len > 0)
+	{
+		ssize_t got = read(fd, walker, len);
+		if(got <= 0)
+			return false;
+		walker += got;
+		len    -= (size_t)got;
+	}
+	return true;
 }
 
-bool round_robin(dyn_array_t *ready_queue, ScheduleResult_t *result, size_t quantum) 
+// PCBs converted from records before being appended to the queue in one go, 1024 * 16 bytes
+#define PCB_LOAD_BLOCK 1024
+
+// private function
+// fills the queue from a block of packed records in a single pass
+// the last record is pushed first so the back of the queue is the first PCB in the file
+static dyn_array_t *pcbs_from_records(const uint8_t *records, uint32_t elements)
 {
-	(void)(ready_queue);
-	(void)(result);
-	(void)(quantum);
-	return false;
+	dyn_array_t* PCBs = dyn_array_create(elements, sizeof(ProcessControlBlock_t), NULL);
+	if(PCBs == NULL)
+		return NULL;
+
+	// converted a block at a time and appended in one copy per block
+	ProcessControlBlock_t block[PCB_LOAD_BLOCK];
+	for(size_t i = elements; i > 0; )
+	{
+		size_t count = 0;
+		for(; i > 0 && count < PCB_LOAD_BLOCK; i--, count++)
+		{
+			uint32_t info[3]; // burst time, priority, arrival
+			memcpy(info, records + (i - 1) * PCB_FILE_RECORD_SIZE, PCB_FILE_RECORD_SIZE);
+
+			ProcessControlBlock_t *pcb = &block[count];
+			pcb->remaining_burst_time = info[0];
+			pcb->priority             = info[1];
+			pcb->arrival              = info[2];
+			pcb->started              = false;
+		}
+		if(!dyn_array_push_back_n(PCBs, block, count))
+		{
+			dyn_array_destroy(PCBs);
+			return NULL;
+		}
+	}
+	return PCBs;
 }
 
-dyn_array_t *load_process_control_blocks(const char *input_file) 
+// private function
+// opens a PCB file and reads its header
+// checks the name, that there is at least one record and, for a regular file, that every record is there
+// \return the open file descriptor positioned at the first record, -1 for an error
+static int open_pcb_file(const char *input_file, uint32_t *elements, bool *regular)
 {
 	// checks for valid input file
 	if(input_file == NULL)
-		return NULL;
+		return -1;
 	const char* badChars = "\n\t\r\v\f";
 	for(int i = 0; i < 32; i++)
 	{
@@ -102,85 +710,518 @@ dyn_array_t *load_process_control_blocks(const char *input_file)
 		for(int j = 0; j < 5; j++)
 		{
 			if(input_file[i] == badChars[j])
-				return NULL;
+				return -1;
 		}
 	}
 
-	FILE* file = fopen(input_file, "rb");
-	if(file == NULL)
-		return NULL;
+	int fd = open(input_file, O_RDONLY);
+	if(fd < 0)
+		return -1;
 
-	// reads the first element of the file to see the size
-	uint32_t elements = 0;
-	if(!fread(&elements, 4, 1, file))
+	struct stat info;
+	if(fstat(fd, &info) != 0)
 	{
-		fclose(file);
-		return NULL;
+		close(fd);
+		return -1;
 	}
 
+	// reads the first element of the file to see the size
 	// checks that there are elements to read
-	if(elements == 0)
+	if(!read_fully(fd, elements, PCB_FILE_HEADER_SIZE) || *elements == 0)
 	{
-		fclose(file);
-		return NULL;
+		close(fd);
+		return -1;
 	}
 
-	// array to hold read PCBs
-	dyn_array_t* PCBs = dyn_array_create(elements, sizeof(ProcessControlBlock_t), NULL);
-	if(PCBs == NULL)
+	// checks once that the file really holds every record the header promises
+	*regular = S_ISREG(info.st_mode);
+	if(*regular && (uint64_t)info.st_size < PCB_FILE_HEADER_SIZE + (uint64_t)*elements * PCB_FILE_RECORD_SIZE)
 	{
-		fclose(file);
-		return NULL;
+		close(fd);
+		return -1;
 	}
+	return fd;
+}
+
+dyn_array_t *load_process_control_blocks(const char *input_file) 
+{
+	uint32_t elements = 0;
+	bool regular = false;
+	int fd = open_pcb_file(input_file, &elements, &regular);
+	if(fd < 0)
+		return NULL;
+
+	size_t records_size = (size_t)elements * PCB_FILE_RECORD_SIZE;
+	dyn_array_t* PCBs = NULL;
 
-	int ctr = 0; // counter to keep track of what we are reading ie burst time, priority, or arrival
-	ProcessControlBlock_t* currentPCB = NULL;
-	for(uint32_t i = 0; i < elements * 3; i++)
+	if(regular)
 	{
-		uint32_t info; // stores the info read
-		if(!fread(&info, 4, 1, file))
+		// map the file and read the records straight out of the page cache
+		void *image = mmap(NULL, PCB_FILE_HEADER_SIZE + records_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if(image != MAP_FAILED)
 		{
-			free(currentPCB);
-			dyn_array_destroy(PCBs);
-			fclose(file);
-			return NULL;
+			posix_madvise(image, PCB_FILE_HEADER_SIZE + records_size, POSIX_MADV_SEQUENTIAL);
+			PCBs = pcbs_from_records((const uint8_t *)image + PCB_FILE_HEADER_SIZE, elements);
+			munmap(image, PCB_FILE_HEADER_SIZE + records_size);
+			close(fd);
+			return PCBs;
 		}
-		// checks which info is read and creates a new PCB when needed
-		switch(ctr)
+	}
+
+	// not mappable (pipe, special file, ...), read every record in one block instead
+	uint8_t *records = malloc(records_size);
+	if(records != NULL && read_fully(fd, records, records_size))
+		PCBs = pcbs_from_records(records, elements);
+
+	free(records);
+	close(fd);
+	return PCBs;
+}
+
+// records read from the file at a time by a PCB stream, 4096 * 12 bytes
+#define PCB_STREAM_BLOCK 4096
+
+struct pcb_stream
+{
+	int fd;
+	uint32_t unread;		// records still in the file
+	size_t buffered;		// records in block
+	size_t position;		// next record in block
+	bool failed;			// a read came up short
+	uint8_t block[PCB_STREAM_BLOCK * PCB_FILE_RECORD_SIZE];
+};
+
+pcb_stream_t *pcb_stream_open(const char *input_file)
+{
+	uint32_t elements = 0;
+	bool regular = false;
+	int fd = open_pcb_file(input_file, &elements, &regular);
+	if(fd < 0)
+		return NULL;
+
+	pcb_stream_t *stream = malloc(sizeof(pcb_stream_t));
+	if(stream == NULL)
+	{
+		close(fd);
+		return NULL;
+	}
+	if(regular)
+		posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+	stream->fd       = fd;
+	stream->unread   = elements;
+	stream->buffered = 0;
+	stream->position = 0;
+	stream->failed   = false;
+	return stream;
+}
+
+bool pcb_stream_next(pcb_stream_t *stream, ProcessControlBlock_t *pcb)
+{
+	if(stream == NULL || pcb == NULL || stream->failed)
+		return false;
+
+	if(stream->position == stream->buffered)
+	{
+		if(stream->unread == 0)
+			return false;
+
+		// refill the block, only this much of the file is ever held in memory
+		size_t records = stream->unread < PCB_STREAM_BLOCK ? stream->unread : PCB_STREAM_BLOCK;
+		if(!read_fully(stream->fd, stream->block, records * PCB_FILE_RECORD_SIZE))
 		{
-			case 0:
-				currentPCB = malloc(sizeof(ProcessControlBlock_t));
-				currentPCB->remaining_burst_time = info;
-				ctr++;
-				break;
-			case 1:
-				currentPCB->priority = info;
-				ctr++;
-				break;
-			case 2:
-				currentPCB->arrival = info;
-				currentPCB->started = false;
-				if(!dyn_array_push_front(PCBs, currentPCB))
-				{
-					free(currentPCB);
-					dyn_array_destroy(PCBs);
-					fclose(file);
-					return NULL;
-				}
-				free(currentPCB);
-				currentPCB = NULL;
-				ctr = 0;
-				break;
+			stream->failed = true;
+			return false;
 		}
+		stream->unread  -= (uint32_t)records;
+		stream->buffered = records;
+		stream->position = 0;
 	}
 
-	fclose(file);
-	return PCBs;
+	uint32_t info[3]; // burst time, priority, arrival
+	memcpy(info, stream->block + stream->position * PCB_FILE_RECORD_SIZE, PCB_FILE_RECORD_SIZE);
+	stream->position++;
+
+	pcb->remaining_burst_time = info[0];
+	pcb->priority             = info[1];
+	pcb->arrival              = info[2];
+	pcb->started              = false;
+	return true;
+}
+
+bool pcb_stream_failed(const pcb_stream_t *stream)
+{
+	return stream == NULL || stream->failed;
+}
+
+void pcb_stream_close(pcb_stream_t *stream)
+{
+	if(stream == NULL)
+		return;
+	close(stream->fd);
+	free(stream);
+}
+
+// SRTF ready set
+// indexed dyn_heap keyed on remaining time (same ordering as SJF)
+// the running job stays in the heap, so at each arrival it only costs a
+// decrease-key to account for the work it just did
+typedef struct
+{
+	dyn_heap_t *heap;
+	size_t running;	// handle of the job currently on the CPU
+} IndexedJobHeap_t;
+
+static bool indexed_heap_admit(void *ready_set, const SimJob_t *job)
+{
+	return dyn_heap_push(((IndexedJobHeap_t *)ready_set)->heap, job, NULL);
+}
+
+static bool indexed_heap_select(void *ready_set, SimJob_t *job)
+{
+	IndexedJobHeap_t *indexed = (IndexedJobHeap_t *)ready_set;
+	if(!dyn_heap_peek_handle(indexed->heap, &indexed->running))
+		return false;
+	*job = *(const SimJob_t *)dyn_heap_at(indexed->heap, indexed->running);
+	return true;
+}
+
+static bool indexed_heap_requeue(void *ready_set, const SimJob_t *job)
+{
+	// remaining time only ever goes down while running
+	IndexedJobHeap_t *indexed = (IndexedJobHeap_t *)ready_set;
+	return dyn_heap_decrease_key(indexed->heap, indexed->running, job);
+}
+
+static bool indexed_heap_retire(void *ready_set, const SimJob_t *job)
+{
+	// an arrival during the last slice may already sit above it, so remove by handle
+	(void)(job);
+	IndexedJobHeap_t *indexed = (IndexedJobHeap_t *)ready_set;
+	SimJob_t finished;
+	return dyn_heap_extract_handle(indexed->heap, indexed->running, &finished);
+}
+
+// private function
+// runs the jobs from feed preemptively, shortest remaining time first
+static bool indexed_heap_schedule(const SimFeed_t *feed, size_t capacity, const ScheduleOutputs_t *outputs,
+								  ScheduleResult_t *result)
+{
+	IndexedJobHeap_t indexed = { dyn_heap_create(capacity, sizeof(SimJob_t), compare_shortest_burst, NULL), 0 };
+	if(indexed.heap == NULL)
+		return false;
+
+	// slices end at the next arrival, which is the only time a preemption can happen
+	SimPolicy_t policy = { indexed_heap_admit, indexed_heap_select, indexed_heap_requeue, indexed_heap_retire,
+						   &indexed, 0, true, NULL, NULL, NULL };
+
+	bool success = sim_run_feed(feed, &policy, outputs, result);
+	dyn_heap_destroy(indexed.heap);
+	return success;
+}
+
+bool shortest_remaining_time_first_view(const PcbView_t *view, ScheduleResult_t *result,
+										const ScheduleOutputs_t *outputs)
+{
+	// validate inputs
+	if(view == NULL || result == NULL)
+		return false;
+
+	SimFeed_t feed;
+	SimViewCursor_t cursor;
+	if(!sim_feed_from_view(&feed, &cursor, view, true))
+		return false;
+
+	bool success = indexed_heap_schedule(&feed, view->count, outputs, result);
+	sim_view_cursor_release(&cursor);
+	return success;
+}
+
+bool shortest_remaining_time_first_detailed(dyn_array_t *ready_queue, ScheduleResult_t *result,
+											 const ScheduleOutputs_t *outputs)
+{
+	PcbView_t view;
+	if(!pcb_view_from_queue(&view, ready_queue) || !shortest_remaining_time_first_view(&view, result, outputs))
+		return false;
+	// like the other schedulers, the queue is used up by the run, and its peak capacity is given back
+	dyn_array_clear(ready_queue);
+	dyn_array_shrink_to_fit(ready_queue);
+	return true;
 }
 
 bool shortest_remaining_time_first(dyn_array_t *ready_queue, ScheduleResult_t *result) 
 {
-	(void)(ready_queue);
-	(void)(result);
-	return false;
+	return shortest_remaining_time_first_detailed(ready_queue, result, NULL);
+}
+
+// Stream feed
+// pulls one PCB at a time from a pcb_stream_t, pids count up from the first record in the file
+typedef struct
+{
+	pcb_stream_t *stream;
+	SimJob_t next;			// the job peek returned, valid while peeked is set
+	bool peeked;
+	size_t pulled;			// records taken from the stream so far
+	bool in_order;			// the policy needs the records in arrival order
+	bool out_of_order;		// an arrival went backwards, the feed stopped there
+} StreamFeed_t;
+
+static const SimJob_t *stream_feed_peek(void *source)
+{
+	StreamFeed_t *feed = (StreamFeed_t *)source;
+	if(feed->peeked)
+		return &feed->next;
+	if(feed->out_of_order)
+		return NULL;
+
+	uint32_t previous = feed->next.pcb.arrival;
+	if(!pcb_stream_next(feed->stream, &feed->next.pcb))
+		return NULL;
+
+	// the engine admits in feed order, so a policy that sorts by arrival cannot take an earlier arrival late
+	if(feed->in_order && feed->pulled > 0 && feed->next.pcb.arrival < previous)
+	{
+		feed->out_of_order = true;
+		return NULL;
+	}
+	feed->next.pid   = feed->pulled++;
+	feed->next.burst = feed->next.pcb.remaining_burst_time;
+	feed->next.level = 0;
+	feed->peeked   = true;
+	return &feed->next;
+}
+
+static void stream_feed_advance(void *source)
+{
+	((StreamFeed_t *)source)->peeked = false;
+}
+
+// private function
+// wraps stream in a feed, in_order set for policies that expect the file in arrival order
+static void stream_feed_init(SimFeed_t *feed, StreamFeed_t *state, pcb_stream_t *stream, bool in_order)
+{
+	state->stream           = stream;
+	state->next.pid         = 0;
+	state->next.pcb.arrival = 0;
+	state->peeked           = false;
+	state->pulled           = 0;
+	state->in_order         = in_order;
+	state->out_of_order     = false;
+
+	feed->peek    = stream_feed_peek;
+	feed->advance = stream_feed_advance;
+	feed->source  = state;
+}
+
+// private function
+// a streamed run only counts if the whole file went through the engine
+static bool stream_feed_finished(const StreamFeed_t *state, bool success)
+{
+	return success && !state->out_of_order && !pcb_stream_failed(state->stream);
+}
+
+// the ready sets start small and grow with the number of jobs waiting at once
+#define STREAM_READY_SET_CAPACITY 64
+
+bool first_come_first_serve_stream(pcb_stream_t *stream, ScheduleResult_t *result, const ScheduleOutputs_t *outputs)
+{
+	// validate inputs
+	if(stream == NULL || result == NULL)
+		return false;
+
+	// queue order is file order, with no window into a job array the run queue holds the waiting jobs
+	SimFeed_t feed;
+	StreamFeed_t state;
+	stream_feed_init(&feed, &state, stream, false);
+	bool success = run_queue_schedule(&feed, STREAM_READY_SET_CAPACITY, 0, outputs, result);
+	return stream_feed_finished(&state, success);
+}
+
+bool shortest_job_first_stream(pcb_stream_t *stream, ScheduleResult_t *result, const ScheduleOutputs_t *outputs)
+{
+	// validate inputs
+	if(stream == NULL || result == NULL)
+		return false;
+
+	SimFeed_t feed;
+	StreamFeed_t state;
+	stream_feed_init(&feed, &state, stream, true);
+	bool success = job_heap_schedule(&feed, STREAM_READY_SET_CAPACITY, outputs, result);
+	return stream_feed_finished(&state, success);
+}
+
+bool round_robin_stream(pcb_stream_t *stream, ScheduleResult_t *result, size_t quantum,
+						const ScheduleOutputs_t *outputs)
+{
+	// validate inputs
+	if(stream == NULL || result == NULL || quantum == 0)
+		return false;
+
+	SimFeed_t feed;
+	StreamFeed_t state;
+	stream_feed_init(&feed, &state, stream, true);
+	bool success = run_queue_schedule(&feed, STREAM_READY_SET_CAPACITY, quantum, outputs, result);
+	return stream_feed_finished(&state, success);
+}
+
+bool shortest_remaining_time_first_stream(pcb_stream_t *stream, ScheduleResult_t *result, const ScheduleOutputs_t *outputs)
+{
+	// validate inputs
+	if(stream == NULL || result == NULL)
+		return false;
+
+	SimFeed_t feed;
+	StreamFeed_t state;
+	stream_feed_init(&feed, &state, stream, true);
+	bool success = indexed_heap_schedule(&feed, STREAM_READY_SET_CAPACITY, outputs, result);
+	return stream_feed_finished(&state, success);
+}
+
+bool priority_stream(pcb_stream_t *stream, ScheduleResult_t *result, const PriorityConfig_t *config,
+					 const ScheduleOutputs_t *outputs)
+{
+	// validate inputs
+	if(stream == NULL || result == NULL || config == NULL)
+		return false;
+
+	SimFeed_t feed;
+	StreamFeed_t state;
+	stream_feed_init(&feed, &state, stream, true);
+	bool success = priority_schedule(&feed, STREAM_READY_SET_CAPACITY, config, outputs, result);
+	return stream_feed_finished(&state, success);
+}
+
+bool multilevel_feedback_queue_stream(pcb_stream_t *stream, ScheduleResult_t *result, const MlfqConfig_t *config,
+									  const ScheduleOutputs_t *outputs)
+{
+	// validate inputs
+	if(stream == NULL || result == NULL || !mlfq_config_valid(config))
+		return false;
+
+	SimFeed_t feed;
+	StreamFeed_t state;
+	stream_feed_init(&feed, &state, stream, true);
+	bool success = feedback_schedule(&feed, STREAM_READY_SET_CAPACITY, config, outputs, result);
+	return stream_feed_finished(&state, success);
+}
+
+// private function
+// runs the jobs of ready_queue on num_cores cores, each ready set a copy of prototype around
+// a heap of SimJob_t ordered by compare, or a run queue when compare is NULL
+static bool smp_schedule(dyn_array_t *ready_queue, bool by_arrival, const SimPolicy_t *prototype,
+						 int (*compare)(const void *, const void *), size_t num_cores, SmpQueueing_t queueing,
+						 SmpCoreStats_t *cores, ScheduleResult_t *result)
+{
+	// validate inputs
+	if(ready_queue == NULL || result == NULL || num_cores == 0)
+		return false;
+	if(queueing != SMP_GLOBAL_QUEUE && queueing != SMP_PER_CORE_QUEUES)
+		return false;
+
+	if(dyn_array_size(ready_queue) == 0)
+		return false;
+
+	dyn_array_t *jobs = sim_jobs_from_queue(ready_queue);
+	if(jobs == NULL)
+		return false;
+	// the drained queue would otherwise hold its peak capacity for as long as the caller keeps it
+	dyn_array_shrink_to_fit(ready_queue);
+	SimFeed_t feed;
+	SimJobCursor_t cursor;
+	if((by_arrival && !sim_sort_by_arrival(jobs)) || !sim_feed_from_jobs(&feed, &cursor, jobs))
+	{
+		dyn_array_destroy(jobs);
+		return false;
+	}
+
+	// per-core ready sets start at an even share and grow if stealing leaves them uneven
+	size_t num_queues = queueing == SMP_GLOBAL_QUEUE ? 1 : num_cores;
+	size_t capacity   = dyn_array_size(jobs) / num_queues + 1;
+	SimPolicy_t *policies = calloc(num_queues, sizeof(SimPolicy_t));
+	bool success = policies != NULL;
+	bool heap    = compare != NULL;
+	for(size_t queue = 0; success && queue < num_queues; queue++)
+	{
+		policies[queue] = *prototype;
+		policies[queue].ready_set = heap ? (void *)dyn_heap_create(capacity, sizeof(SimJob_t), compare, NULL)
+										 : (void *)dyn_ring_create_with_allocator(capacity, sizeof(SimJob_t), NULL,
+																				  sim_scratch_allocator());
+		success = policies[queue].ready_set != NULL;
+	}
+
+	if(success)
+		success = smp_run_feed(&feed, policies, num_queues, num_cores, cores, result);
+
+	for(size_t queue = 0; policies != NULL && queue < num_queues; queue++)
+	{
+		if(heap)
+			dyn_heap_destroy((dyn_heap_t *)policies[queue].ready_set);
+		else
+			dyn_ring_destroy((dyn_ring_t *)policies[queue].ready_set);
+	}
+	free(policies);
+	dyn_array_destroy(jobs);
+	return success;
+}
+
+bool first_come_first_serve_smp(dyn_array_t *ready_queue, ScheduleResult_t *result, size_t num_cores,
+								SmpQueueing_t queueing, SmpCoreStats_t *cores)
+{
+	// queue order, run to completion, like first_come_first_serve_stream
+	SimPolicy_t prototype = { run_queue_admit, run_queue_select, run_queue_admit, NULL, NULL, 0, false, NULL, NULL, NULL };
+	return smp_schedule(ready_queue, false, &prototype, NULL, num_cores, queueing, cores, result);
+}
+
+bool shortest_job_first_smp(dyn_array_t *ready_queue, ScheduleResult_t *result, size_t num_cores,
+							SmpQueueing_t queueing, SmpCoreStats_t *cores)
+{
+	SimPolicy_t prototype = { job_heap_admit, job_heap_select, job_heap_requeue, NULL, NULL, 0, false, NULL, NULL, NULL };
+	return smp_schedule(ready_queue, true, &prototype, compare_shortest_burst, num_cores, queueing, cores, result);
+}
+
+// private function
+// plain heap order for priority across cores, the same order as compare_priority_key without aging
+static int compare_priority_job(const void *a, const void *b)
+{
+	const SimJob_t *lhs = (const SimJob_t *)a;
+	const SimJob_t *rhs = (const SimJob_t *)b;
+	if(lhs->pcb.priority != rhs->pcb.priority)
+		return lhs->pcb.priority < rhs->pcb.priority ? -1 : 1;
+	if(lhs->pcb.arrival != rhs->pcb.arrival)
+		return lhs->pcb.arrival < rhs->pcb.arrival ? -1 : 1;
+	if(lhs->pid != rhs->pid)
+		return lhs->pid < rhs->pid ? -1 : 1;
+	return 0;
+}
+
+bool priority_smp(dyn_array_t *ready_queue, ScheduleResult_t *result, const PriorityConfig_t *config,
+				  size_t num_cores, SmpQueueing_t queueing, SmpCoreStats_t *cores)
+{
+	// aging rekeys waiting jobs as the clock moves, which the multi-core engine does not simulate
+	if(config == NULL || config->aging_interval != 0)
+		return false;
+
+	// like SRTF, a preempted job leaves its core and goes back into the heap at the end of its slice
+	SimPolicy_t prototype = { job_heap_admit, job_heap_select, config->preemptive ? job_heap_admit : job_heap_requeue,
+							  NULL, NULL, 0, config->preemptive, NULL, NULL, NULL };
+	return smp_schedule(ready_queue, true, &prototype, compare_priority_job, num_cores, queueing, cores, result);
+}
+
+bool round_robin_smp(dyn_array_t *ready_queue, ScheduleResult_t *result, size_t quantum, size_t num_cores,
+					 SmpQueueing_t queueing, SmpCoreStats_t *cores)
+{
+	if(quantum == 0)
+		return false;
+	SimPolicy_t prototype = { run_queue_admit, run_queue_select, run_queue_admit, NULL, NULL, quantum, false,
+							  NULL, NULL, NULL };
+	return smp_schedule(ready_queue, true, &prototype, NULL, num_cores, queueing, cores, result);
+}
+
+bool shortest_remaining_time_first_smp(dyn_array_t *ready_queue, ScheduleResult_t *result, size_t num_cores,
+									   SmpQueueing_t queueing, SmpCoreStats_t *cores)
+{
+	// the indexed heap keeps a single running job in place, with many cores each one comes out
+	// of a plain heap while it runs and goes back in at the end of its slice
+	SimPolicy_t prototype = { job_heap_admit, job_heap_select, job_heap_admit, NULL, NULL, 0, true, NULL, NULL, NULL };
+	return smp_schedule(ready_queue, true, &prototype, compare_shortest_burst, num_cores, queueing, cores, result);
 }
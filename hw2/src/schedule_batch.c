@@ -0,0 +1,359 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "dyn_arena.h"
+#include "dyn_array.h"
+#include "processing_scheduling.h"
+#include "schedule_batch.h"
+#include "sim_engine.h"
+
+#define FCFS "FCFS"
+#define P "P"
+#define RR "RR"
+#define SJF "SJF"
+#define SRT "SRT"
+#define ALL "ALL"
+
+// private function
+// fills in a request, false if the round robin quantum is missing
+static bool make_request(ScheduleRequest_t *request, ScheduleAlgorithm_t algorithm, const char *name, size_t quantum)
+{
+	request->algorithm = algorithm;
+	request->quantum   = quantum;
+	if(algorithm == SCHEDULE_RR)
+	{
+		if(quantum == 0)
+			return false;
+		snprintf(request->name, sizeof(request->name), "%s:%zu", name, quantum);
+	}
+	else
+	{
+		snprintf(request->name, sizeof(request->name), "%s", name);
+	}
+	return true;
+}
+
+// private function
+// parses a single token such as "SJF" or "RR:4"
+static bool parse_request(const char *token, size_t len, size_t default_quantum, ScheduleRequest_t *request)
+{
+	char name[16];
+	if(len == 0 || len >= sizeof(name))
+		return false;
+	memcpy(name, token, len);
+	name[len] = '\0';
+
+	if(strcmp(name, FCFS) == 0)
+		return make_request(request, SCHEDULE_FCFS, FCFS, 0);
+	if(strcmp(name, SJF) == 0)
+		return make_request(request, SCHEDULE_SJF, SJF, 0);
+	if(strcmp(name, P) == 0)
+		return make_request(request, SCHEDULE_PRIORITY, P, 0);
+	if(strcmp(name, SRT) == 0)
+		return make_request(request, SCHEDULE_SRTF, SRT, 0);
+	if(strcmp(name, RR) == 0)
+		return make_request(request, SCHEDULE_RR, RR, default_quantum);
+
+	// RR:<quantum>
+	if(strncmp(name, RR ":", 3) == 0)
+	{
+		char *end = NULL;
+		unsigned long long quantum = strtoull(name + 3, &end, 10);
+		if(end == name + 3 || *end != '\0' || name[3] == '-')
+			return false;
+		return make_request(request, SCHEDULE_RR, RR, (size_t)quantum);
+	}
+	return false;
+}
+
+dyn_array_t *schedule_batch_parse(const char *spec, size_t default_quantum)
+{
+	if(spec == NULL)
+		return NULL;
+
+	dyn_array_t *requests = dyn_array_create(0, sizeof(ScheduleRequest_t), NULL);
+	if(requests == NULL)
+		return NULL;
+
+	if(strcmp(spec, ALL) == 0)
+	{
+		// every policy, in the order the header lists them, and RR always gets a quantum
+		static const char *const all_policies = FCFS "," SJF "," P "," RR "," SRT;
+		dyn_array_destroy(requests);
+		return schedule_batch_parse(all_policies, default_quantum != 0 ? default_quantum : SCHEDULE_ALL_QUANTUM);
+	}
+
+	const char *token = spec;
+	for(;;)
+	{
+		const char *comma = strchr(token, ',');
+		size_t len = comma ? (size_t)(comma - token) : strlen(token);
+
+		ScheduleRequest_t request;
+		if(!parse_request(token, len, default_quantum, &request) || !dyn_array_push_back(requests, &request))
+		{
+			dyn_array_destroy(requests);
+			return NULL;
+		}
+
+		if(comma == NULL)
+			break;
+		token = comma + 1;
+	}
+	return requests;
+}
+
+bool schedule_run_view(const PcbView_t *view, const ScheduleRequest_t *request, ScheduleResult_t *result)
+{
+	if(view == NULL || request == NULL || result == NULL)
+		return false;
+
+	const PriorityConfig_t priority_config = { false, 0 };
+	switch(request->algorithm)
+	{
+		case SCHEDULE_FCFS:
+			return first_come_first_serve_view(view, result, NULL);
+		case SCHEDULE_SJF:
+			return shortest_job_first_view(view, result, NULL);
+		case SCHEDULE_PRIORITY:
+			return priority_view(view, result, &priority_config, NULL);
+		case SCHEDULE_RR:
+			return round_robin_view(view, result, request->quantum, NULL);
+		case SCHEDULE_SRTF:
+			return shortest_remaining_time_first_view(view, result, NULL);
+	}
+	return false;
+}
+
+bool schedule_run(dyn_array_t *ready_queue, const ScheduleRequest_t *request, ScheduleResult_t *result)
+{
+	if(ready_queue == NULL || request == NULL || result == NULL)
+		return false;
+
+	switch(request->algorithm)
+	{
+		case SCHEDULE_FCFS:
+			return first_come_first_serve(ready_queue, result);
+		case SCHEDULE_SJF:
+			return shortest_job_first(ready_queue, result);
+		case SCHEDULE_PRIORITY:
+			return priority(ready_queue, result);
+		case SCHEDULE_RR:
+			return round_robin(ready_queue, result, request->quantum);
+		case SCHEDULE_SRTF:
+			return shortest_remaining_time_first(ready_queue, result);
+	}
+	return false;
+}
+
+// work shared by the batch workers
+// every worker claims the next unclaimed run, so results land in request order
+// no matter which worker finishes first
+typedef struct
+{
+	PcbView_t view;				// the ready queue, read by every run at once
+	ScheduleRun_t *runs;
+	bool *done;
+	size_t num_runs;
+	size_t next_run;
+	size_t next_report;
+	ScheduleRunCallback_t on_run;
+	void *context;
+	pthread_mutex_t lock;
+}
+BatchWork_t;
+
+// private function
+// worker loop: claim a run, simulate it, repeat until none are left
+static void *batch_worker(void *arg)
+{
+	BatchWork_t *work = (BatchWork_t *)arg;
+
+	// the runs' scratch comes out of one arena that is reset between them, so once it has grown
+	// to fit the largest run a worker stops calling malloc; without one they just use the heap
+	dyn_arena_t *scratch = dyn_arena_create(0);
+	dyn_allocator_t allocator;
+	if(dyn_arena_allocator(scratch, &allocator))
+		sim_set_scratch_allocator(&allocator);
+
+	for(;;)
+	{
+		pthread_mutex_lock(&work->lock);
+		size_t claimed = work->next_run;
+		if(claimed < work->num_runs)
+			work->next_run++;
+		else
+			claimed = work->num_runs;
+		pthread_mutex_unlock(&work->lock);
+
+		if(claimed == work->num_runs)
+			break;
+
+		// the schedulers only read the view, so no run needs a copy of the queue
+		ScheduleRun_t *run = &work->runs[claimed];
+		run->success = schedule_run_view(&work->view, &run->request, &run->result);
+		dyn_arena_reset(scratch);
+
+		pthread_mutex_lock(&work->lock);
+		work->done[claimed] = true;
+		// report every run that is now complete and has nothing unfinished ahead of it
+		while(work->next_report < work->num_runs && work->done[work->next_report])
+		{
+			if(work->on_run != NULL)
+				work->on_run(&work->runs[work->next_report], work->context);
+			work->next_report++;
+		}
+		pthread_mutex_unlock(&work->lock);
+	}
+
+	sim_set_scratch_allocator(NULL);
+	dyn_arena_destroy(scratch);
+	return NULL;
+}
+
+dyn_array_t *schedule_batch_run(const dyn_array_t *ready_queue, const dyn_array_t *requests, size_t num_threads)
+{
+	return schedule_batch_run_streamed(ready_queue, requests, num_threads, NULL, NULL);
+}
+
+dyn_array_t *schedule_batch_run_streamed(const dyn_array_t *ready_queue, const dyn_array_t *requests,
+										 size_t num_threads, ScheduleRunCallback_t on_run, void *context)
+{
+	if(ready_queue == NULL || requests == NULL || dyn_array_empty(ready_queue))
+		return NULL;
+
+	size_t num_requests = dyn_array_size(requests);
+	dyn_array_t *runs = dyn_array_create(num_requests, sizeof(ScheduleRun_t), NULL);
+	if(runs == NULL)
+		return NULL;
+
+	// lay out every run up front, the workers fill them in place
+	for(size_t i = 0; i < num_requests; i++)
+	{
+		ScheduleRun_t run;
+		run.request = *(const ScheduleRequest_t *)dyn_array_at(requests, i);
+		run.result.average_waiting_time    = 0.0f;
+		run.result.average_turnaround_time = 0.0f;
+		run.result.total_run_time          = 0;
+		run.success = false;
+		if(!dyn_array_push_back(runs, &run))
+		{
+			dyn_array_destroy(runs);
+			return NULL;
+		}
+	}
+	if(num_requests == 0)
+		return runs;
+
+	// one simulation per worker, never more workers than simulations
+	if(num_threads == 0)
+	{
+		long online = sysconf(_SC_NPROCESSORS_ONLN);
+		num_threads = online > 0 ? (size_t)online : 1;
+	}
+	if(num_threads > num_requests)
+		num_threads = num_requests;
+
+	BatchWork_t work;
+	if(!pcb_view_from_queue(&work.view, ready_queue))
+	{
+		dyn_array_destroy(runs);
+		return NULL;
+	}
+	work.runs        = (ScheduleRun_t *)dyn_array_at(runs, 0);
+	work.done        = calloc(num_requests, sizeof(bool));
+	work.num_runs    = num_requests;
+	work.next_run    = 0;
+	work.next_report = 0;
+	work.on_run      = on_run;
+	work.context     = context;
+	if(work.done == NULL || pthread_mutex_init(&work.lock, NULL) != 0)
+	{
+		free(work.done);
+		dyn_array_destroy(runs);
+		return NULL;
+	}
+
+	// the calling thread is worker 0, so a single thread never spawns anything
+	pthread_t *workers = malloc(num_threads * sizeof(pthread_t));
+	size_t spawned = 0;
+	if(workers != NULL)
+	{
+		for(; spawned + 1 < num_threads; spawned++)
+		{
+			if(pthread_create(&workers[spawned], NULL, batch_worker, &work) != 0)
+				break;
+		}
+	}
+	batch_worker(&work);
+	for(size_t i = 0; i < spawned; i++)
+		pthread_join(workers[i], NULL);
+
+	free(workers);
+	free(work.done);
+	pthread_mutex_destroy(&work.lock);
+	return runs;
+}
+
+dyn_array_t *schedule_sweep_parse(const char *range)
+{
+	if(range == NULL)
+		return NULL;
+
+	// first:last[:step], all positive, first <= last
+	unsigned long long bounds[3] = { 0, 0, 1 };
+	char extra;
+	size_t len = strlen(range);
+	if(len == 0 || strspn(range, "0123456789:") != len || range[len - 1] == ':')
+		return NULL;
+	int fields = sscanf(range, "%llu:%llu:%llu%c", &bounds[0], &bounds[1], &bounds[2], &extra);
+	if(fields != 2 && fields != 3)
+		return NULL;
+	if(bounds[0] == 0 || bounds[2] == 0 || bounds[0] > bounds[1])
+		return NULL;
+
+	dyn_array_t *requests = dyn_array_create((size_t)((bounds[1] - bounds[0]) / bounds[2] + 1),
+											 sizeof(ScheduleRequest_t), NULL);
+	if(requests == NULL)
+		return NULL;
+
+	for(unsigned long long quantum = bounds[0]; quantum <= bounds[1]; quantum += bounds[2])
+	{
+		ScheduleRequest_t request;
+		if(!make_request(&request, SCHEDULE_RR, RR, (size_t)quantum) || !dyn_array_push_back(requests, &request))
+		{
+			dyn_array_destroy(requests);
+			return NULL;
+		}
+		// don't wrap around on a last of ULLONG_MAX
+		if(bounds[1] - quantum < bounds[2])
+			break;
+	}
+	return requests;
+}
+
+dyn_array_t *schedule_sweep_run(const dyn_array_t *ready_queue, const dyn_array_t *requests,
+								size_t num_threads, ScheduleRunCallback_t on_run, void *context)
+{
+	if(ready_queue == NULL || requests == NULL || dyn_array_empty(ready_queue))
+		return NULL;
+
+	// one arrival-sorted copy shared by every run, each run then only scans it
+	dyn_array_t *sorted = dyn_array_clone(ready_queue);
+	if(sorted == NULL)
+		return NULL;
+	if(!sim_queue_sort_by_arrival(sorted))
+	{
+		dyn_array_destroy(sorted);
+		return NULL;
+	}
+
+	dyn_array_t *runs = schedule_batch_run_streamed(sorted, requests, num_threads, on_run, context);
+	dyn_array_destroy(sorted);
+	return runs;
+}
@@ -0,0 +1,249 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "schedule_timeline.h"
+
+#define TIMELINE_MAGIC "PCBT"
+#define TIMELINE_MAGIC_SIZE 4
+
+// bytes encoded before each write, and read at a time
+#define TIMELINE_BLOCK 65536
+
+// three varints of at most 10 bytes each
+#define TIMELINE_MAX_RECORD 30
+
+struct schedule_timeline_writer
+{
+	FILE *output;
+	size_t used;			// bytes waiting in block
+	bool failed;			// a write came up short
+	size_t last_pid;
+	uint64_t last_end;
+	uint8_t block[TIMELINE_BLOCK];
+};
+
+struct schedule_timeline_reader
+{
+	FILE *input;
+	size_t size;			// bytes in block
+	size_t position;		// next byte to decode
+	bool failed;
+	size_t last_pid;
+	uint64_t last_end;
+	uint8_t block[TIMELINE_BLOCK];
+};
+
+// private function
+static bool buffer_emit(void *context, const ScheduleSlice_t *slice)
+{
+	ScheduleTimelineBuffer_t *buffer = (ScheduleTimelineBuffer_t *)context;
+	if(buffer->size == buffer->capacity)
+		return false;
+	buffer->slices[buffer->size++] = *slice;
+	return true;
+}
+
+bool schedule_timeline_to_buffer(ScheduleTimeline_t *timeline, ScheduleTimelineBuffer_t *buffer,
+								 ScheduleSlice_t *slices, size_t capacity)
+{
+	if(timeline == NULL || buffer == NULL || (slices == NULL && capacity > 0))
+		return false;
+
+	buffer->slices   = slices;
+	buffer->capacity = capacity;
+	buffer->size     = 0;
+
+	timeline->emit    = buffer_emit;
+	timeline->context = buffer;
+	return true;
+}
+
+// private function
+// signed deltas are zigzagged so small steps either way stay small
+static uint64_t zigzag(uint64_t delta)
+{
+	return (delta << 1) ^ (uint64_t)((int64_t)delta >> 63);
+}
+
+// private function
+static uint64_t unzigzag(uint64_t value)
+{
+	return (value >> 1) ^ (uint64_t)(-(int64_t)(value & 1));
+}
+
+// private function
+// LEB128, seven bits a byte with the high bit set on every byte but the last
+static size_t put_varint(uint8_t *out, uint64_t value)
+{
+	size_t written = 0;
+	while(value >= 0x80)
+	{
+		out[written++] = (uint8_t)(value | 0x80);
+		value >>= 7;
+	}
+	out[written++] = (uint8_t)value;
+	return written;
+}
+
+// private function
+// false if the varint runs past end or past 64 bits
+static bool get_varint(const uint8_t *in, size_t available, size_t *position, uint64_t *value)
+{
+	uint64_t result = 0;
+	for(unsigned shift = 0; shift < 64; shift += 7)
+	{
+		if(*position >= available)
+			return false;
+		uint8_t byte = in[(*position)++];
+		result |= (uint64_t)(byte & 0x7F) << shift;
+		if(!(byte & 0x80))
+		{
+			*value = result;
+			return true;
+		}
+	}
+	return false;
+}
+
+// private function
+static bool writer_flush(schedule_timeline_writer_t *writer)
+{
+	if(writer->used > 0 && fwrite(writer->block, 1, writer->used, writer->output) != writer->used)
+		writer->failed = true;
+	writer->used = 0;
+	return !writer->failed;
+}
+
+// private function
+static bool writer_emit(void *context, const ScheduleSlice_t *slice)
+{
+	schedule_timeline_writer_t *writer = (schedule_timeline_writer_t *)context;
+	if(slice->end < slice->start)
+		return false;
+	if(TIMELINE_BLOCK - writer->used < TIMELINE_MAX_RECORD && !writer_flush(writer))
+		return false;
+
+	uint8_t *out = writer->block + writer->used;
+	size_t written = put_varint(out, zigzag((uint64_t)slice->pid - (uint64_t)writer->last_pid));
+	written += put_varint(out + written, zigzag(slice->start - writer->last_end));
+	written += put_varint(out + written, slice->end - slice->start);
+	writer->used += written;
+
+	writer->last_pid = slice->pid;
+	writer->last_end = slice->end;
+	return true;
+}
+
+schedule_timeline_writer_t *schedule_timeline_writer_create(FILE *output)
+{
+	if(output == NULL)
+		return NULL;
+
+	schedule_timeline_writer_t *writer = malloc(sizeof(schedule_timeline_writer_t));
+	if(writer == NULL)
+		return NULL;
+
+	writer->output   = output;
+	writer->failed   = false;
+	writer->last_pid = 0;
+	writer->last_end = 0;
+	memcpy(writer->block, TIMELINE_MAGIC, TIMELINE_MAGIC_SIZE);
+	writer->used = TIMELINE_MAGIC_SIZE;
+	return writer;
+}
+
+bool schedule_timeline_to_writer(ScheduleTimeline_t *timeline, schedule_timeline_writer_t *writer)
+{
+	if(timeline == NULL || writer == NULL)
+		return false;
+	timeline->emit    = writer_emit;
+	timeline->context = writer;
+	return true;
+}
+
+bool schedule_timeline_writer_finish(schedule_timeline_writer_t *writer)
+{
+	if(writer == NULL)
+		return false;
+	bool success = writer_flush(writer) && fflush(writer->output) == 0;
+	free(writer);
+	return success;
+}
+
+// private function
+// keeps at least a whole record ahead of position unless the file has run out
+static void reader_refill(schedule_timeline_reader_t *reader)
+{
+	size_t left = reader->size - reader->position;
+	if(left >= TIMELINE_MAX_RECORD)
+		return;
+	memmove(reader->block, reader->block + reader->position, left);
+	reader->size     = left + fread(reader->block + left, 1, TIMELINE_BLOCK - left, reader->input);
+	reader->position = 0;
+	if(ferror(reader->input))
+		reader->failed = true;
+}
+
+schedule_timeline_reader_t *schedule_timeline_reader_create(FILE *input)
+{
+	if(input == NULL)
+		return NULL;
+
+	schedule_timeline_reader_t *reader = malloc(sizeof(schedule_timeline_reader_t));
+	if(reader == NULL)
+		return NULL;
+
+	reader->input    = input;
+	reader->size     = 0;
+	reader->position = 0;
+	reader->failed   = false;
+	reader->last_pid = 0;
+	reader->last_end = 0;
+
+	reader_refill(reader);
+	if(reader->failed || reader->size < TIMELINE_MAGIC_SIZE || memcmp(reader->block, TIMELINE_MAGIC, TIMELINE_MAGIC_SIZE) != 0)
+	{
+		free(reader);
+		return NULL;
+	}
+	reader->position = TIMELINE_MAGIC_SIZE;
+	return reader;
+}
+
+bool schedule_timeline_reader_next(schedule_timeline_reader_t *reader, ScheduleSlice_t *slice)
+{
+	if(reader == NULL || slice == NULL || reader->failed)
+		return false;
+
+	reader_refill(reader);
+	if(reader->failed || reader->position == reader->size)
+		return false;
+
+	uint64_t pid_delta, start_delta, length;
+	if(!get_varint(reader->block, reader->size, &reader->position, &pid_delta)
+		|| !get_varint(reader->block, reader->size, &reader->position, &start_delta)
+		|| !get_varint(reader->block, reader->size, &reader->position, &length))
+	{
+		// the file stopped part way through a slice
+		reader->failed = true;
+		return false;
+	}
+
+	slice->pid   = (size_t)((uint64_t)reader->last_pid + unzigzag(pid_delta));
+	slice->start = reader->last_end + unzigzag(start_delta);
+	slice->end   = slice->start + length;
+
+	reader->last_pid = slice->pid;
+	reader->last_end = slice->end;
+	return true;
+}
+
+bool schedule_timeline_reader_failed(const schedule_timeline_reader_t *reader)
+{
+	return reader == NULL || reader->failed;
+}
+
+void schedule_timeline_reader_destroy(schedule_timeline_reader_t *reader)
+{
+	free(reader);
+}
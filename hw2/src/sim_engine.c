@@ -0,0 +1,513 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "dyn_array.h"
+#include "sim_engine.h"
+
+// private function
+// runs the pcb on the virtual CPU for a whole slice at once
+static void virtual_cpu(ProcessControlBlock_t *process_control_block, uint32_t ticks)
+{
+	// decrement the burst time of the pcb by the length of the slice
+	process_control_block->remaining_burst_time -= ticks;
+}
+
+// jobs staged on the stack between bulk moves in and out of a ready queue, 256 * 32 bytes
+#define SIM_TRANSFER_BLOCK 256
+
+// per thread, so every batch worker can give its runs an arena of its own
+static _Thread_local dyn_allocator_t scratch_allocator;
+static _Thread_local bool scratch_allocator_set = false;
+
+void sim_set_scratch_allocator(const dyn_allocator_t *allocator)
+{
+	scratch_allocator_set = allocator != NULL;
+	if(allocator != NULL)
+		scratch_allocator = *allocator;
+}
+
+const dyn_allocator_t *sim_scratch_allocator(void)
+{
+	return scratch_allocator_set ? &scratch_allocator : NULL;
+}
+
+dyn_array_t *sim_jobs_from_queue(dyn_array_t *ready_queue)
+{
+	if(ready_queue == NULL || dyn_array_data_size(ready_queue) != sizeof(ProcessControlBlock_t))
+		return NULL;
+
+	size_t num_processes = dyn_array_size(ready_queue);
+	if(num_processes == 0)
+		return NULL;
+
+	dyn_array_t *jobs = dyn_array_create_with_allocator(num_processes, sizeof(SimJob_t), NULL, sim_scratch_allocator());
+	if(jobs == NULL)
+		return NULL;
+
+	// back of queue = first arrived, so it gets pid 0
+	const ProcessControlBlock_t *pcbs = (const ProcessControlBlock_t *)dyn_array_export(ready_queue);
+	SimJob_t block[SIM_TRANSFER_BLOCK];
+	for(size_t i = 0; i < num_processes; )
+	{
+		size_t count = 0;
+		for(; i < num_processes && count < SIM_TRANSFER_BLOCK; i++, count++)
+		{
+			SimJob_t *job = &block[count];
+			job->pid   = i;
+			job->pcb   = pcbs[num_processes - 1 - i];
+			job->burst = job->pcb.remaining_burst_time;
+			job->level = 0;
+			// nothing has been on the virtual CPU yet, whatever the caller left in the flag
+			job->pcb.started = false;
+		}
+		if(!dyn_array_push_back_n(jobs, block, count))
+		{
+			dyn_array_destroy(jobs);
+			return NULL;
+		}
+	}
+	// the jobs own the PCBs now, the queue is consumed as if each had been extracted
+	dyn_array_clear(ready_queue);
+	return jobs;
+}
+
+static int compare_arrival(const void *a, const void *b)
+{
+	const SimJob_t *lhs = (const SimJob_t *)a;
+	const SimJob_t *rhs = (const SimJob_t *)b;
+	if(lhs->pcb.arrival != rhs->pcb.arrival)
+		return lhs->pcb.arrival < rhs->pcb.arrival ? -1 : 1;
+	if(lhs->pid != rhs->pid)
+		return lhs->pid < rhs->pid ? -1 : 1;
+	return 0;
+}
+
+bool sim_sort_by_arrival(dyn_array_t *jobs)
+{
+	if(jobs == NULL)
+		return false;
+
+	// input that was sorted ahead of time (e.g. once for a whole sweep) only costs a scan
+	const SimJob_t *walker = (const SimJob_t *)dyn_array_export(jobs);
+	size_t num_jobs = dyn_array_size(jobs);
+	size_t i = 1;
+	while(i < num_jobs && compare_arrival(&walker[i - 1], &walker[i]) < 0)
+		i++;
+	if(i >= num_jobs)
+		return true;
+
+	// jobs straight from sim_jobs_from_queue are in pid order, so a stable sort on arrival
+	// alone breaks ties by pid just like compare_arrival, in a few linear radix passes
+	bool by_pid = true;
+	for(size_t j = 1; by_pid && j < num_jobs; j++)
+		by_pid = walker[j - 1].pid < walker[j].pid;
+	if(by_pid)
+		return dyn_array_sort_by_key(jobs, offsetof(SimJob_t, pcb) + offsetof(ProcessControlBlock_t, arrival),
+									 sizeof(uint32_t));
+	return dyn_array_sort(jobs, compare_arrival);
+}
+
+bool sim_queue_sort_by_arrival(dyn_array_t *ready_queue)
+{
+	if(ready_queue == NULL || dyn_array_data_size(ready_queue) != sizeof(ProcessControlBlock_t))
+		return false;
+	if(dyn_array_size(ready_queue) < 2)
+		return true;
+
+	dyn_array_t *jobs = sim_jobs_from_queue(ready_queue);
+	if(jobs == NULL || !sim_sort_by_arrival(jobs))
+	{
+		dyn_array_destroy(jobs);
+		return false;
+	}
+
+	// put them back last first, so the earliest arrival ends up at the back again
+	const SimJob_t *sorted = (const SimJob_t *)dyn_array_export(jobs);
+	ProcessControlBlock_t block[SIM_TRANSFER_BLOCK];
+	for(size_t i = dyn_array_size(jobs); i > 0; )
+	{
+		size_t count = 0;
+		for(; i > 0 && count < SIM_TRANSFER_BLOCK; i--, count++)
+			block[count] = sorted[i - 1].pcb;
+		if(!dyn_array_push_back_n(ready_queue, block, count))
+		{
+			dyn_array_destroy(jobs);
+			return false;
+		}
+	}
+	dyn_array_destroy(jobs);
+	return true;
+}
+
+double sim_exact_average(ScheduleTotal_t total, uint64_t count)
+{
+	if(count == 0)
+		return 0.0;
+	// the sums lost nothing, so unlike a float running sum there is no error to compensate for
+	// splitting off the remainder keeps the division exact until the last conversion, within an ulp
+	ScheduleTotal_t quotient = total / count;
+	uint64_t remainder = (uint64_t)(total % count);
+	return (double)quotient + (double)remainder / (double)count;
+}
+
+void sim_result_from_totals(ScheduleResult_t *result, const SimTotals_t *totals)
+{
+	if(result == NULL || totals == NULL || totals->num_processes == 0)
+		return;
+	// the totals are exact, so only the final division rounds
+	result->total_run_time          = (unsigned long)totals->run_time;
+	result->average_waiting_time    = (float)sim_exact_average(totals->response_time, totals->num_processes);
+	result->average_turnaround_time = (float)sim_exact_average(totals->turnaround_time, totals->num_processes);
+}
+
+bool sim_recorder_init(SimRecorder_t *recorder, const ScheduleOutputs_t *outputs)
+{
+	if(recorder == NULL)
+		return false;
+
+	recorder->timeline   = outputs != NULL ? outputs->timeline : NULL;
+	recorder->stats      = outputs != NULL ? outputs->stats : NULL;
+	recorder->ready      = NULL;
+	recorder->turnaround = NULL;
+	recorder->response   = NULL;
+	if(recorder->stats == NULL)
+		return true;
+
+	recorder->ready      = latency_histogram_create();
+	recorder->turnaround = latency_histogram_create();
+	recorder->response   = latency_histogram_create();
+	if(recorder->ready == NULL || recorder->turnaround == NULL || recorder->response == NULL)
+	{
+		sim_recorder_finish(recorder, NULL);
+		return false;
+	}
+	return true;
+}
+
+bool sim_recorder_slice(SimRecorder_t *recorder, const SimJob_t *job, uint64_t start, uint64_t end)
+{
+	// response time = first dispatch time - arrival time
+	if(!job->pcb.started)
+		latency_histogram_record(recorder->response, start - job->pcb.arrival);
+	if(recorder->timeline == NULL)
+		return true;
+	ScheduleSlice_t record = { job->pid, start, end };
+	return recorder->timeline->emit(recorder->timeline->context, &record);
+}
+
+void sim_recorder_complete(SimRecorder_t *recorder, const SimJob_t *job, uint64_t completion)
+{
+	// time ready = turnaround time - the time spent running
+	uint64_t turnaround = completion - job->pcb.arrival;
+	latency_histogram_record(recorder->turnaround, turnaround);
+	latency_histogram_record(recorder->ready, turnaround - job->burst);
+}
+
+// private function
+static void quantiles_from_histogram(ScheduleQuantiles_t *quantiles, const latency_histogram_t *histogram)
+{
+	quantiles->p50 = latency_histogram_quantile(histogram, 0.50);
+	quantiles->p90 = latency_histogram_quantile(histogram, 0.90);
+	quantiles->p99 = latency_histogram_quantile(histogram, 0.99);
+	quantiles->max = latency_histogram_max(histogram);
+}
+
+void sim_recorder_finish(SimRecorder_t *recorder, const SimTotals_t *totals)
+{
+	if(recorder == NULL)
+		return;
+	ScheduleStats_t *stats = recorder->stats;
+	if(stats != NULL && totals != NULL && recorder->ready != NULL && recorder->turnaround != NULL
+		&& recorder->response != NULL)
+	{
+		quantiles_from_histogram(&stats->ready, recorder->ready);
+		quantiles_from_histogram(&stats->turnaround, recorder->turnaround);
+		quantiles_from_histogram(&stats->response, recorder->response);
+		stats->cpu_utilisation = totals->run_time == 0 ? 0.0f
+							   : (float)sim_exact_average(totals->burst_time, totals->run_time);
+
+		// ready = turnaround - burst, summed over every process
+		stats->num_processes           = totals->num_processes;
+		stats->total_ready_time        = totals->turnaround_time - totals->burst_time;
+		stats->total_turnaround_time   = totals->turnaround_time;
+		stats->total_response_time     = totals->response_time;
+		stats->average_ready_time      = sim_exact_average(stats->total_ready_time, totals->num_processes);
+		stats->average_turnaround_time = sim_exact_average(stats->total_turnaround_time, totals->num_processes);
+		stats->average_response_time   = sim_exact_average(stats->total_response_time, totals->num_processes);
+	}
+	latency_histogram_destroy(recorder->ready);
+	latency_histogram_destroy(recorder->turnaround);
+	latency_histogram_destroy(recorder->response);
+	recorder->ready      = NULL;
+	recorder->turnaround = NULL;
+	recorder->response   = NULL;
+}
+
+// private function
+// array feed: the next job in the array, NULL past the end
+static const SimJob_t *job_cursor_peek(void *source)
+{
+	SimJobCursor_t *cursor = (SimJobCursor_t *)source;
+	return cursor->next < cursor->count ? &cursor->jobs[cursor->next] : NULL;
+}
+
+// private function
+static void job_cursor_advance(void *source)
+{
+	((SimJobCursor_t *)source)->next++;
+}
+
+bool sim_feed_from_jobs(SimFeed_t *feed, SimJobCursor_t *cursor, const dyn_array_t *jobs)
+{
+	if(feed == NULL || cursor == NULL || jobs == NULL)
+		return false;
+
+	cursor->jobs  = (const SimJob_t *)dyn_array_export(jobs);
+	cursor->count = dyn_array_size(jobs);
+	cursor->next  = 0;
+
+	feed->peek    = job_cursor_peek;
+	feed->advance = job_cursor_advance;
+	feed->source  = cursor;
+	return true;
+}
+
+// private function
+// copies the PCB with the given pid out of view, pid 0 is the back of the queue
+static void view_pcb(const PcbView_t *view, size_t pid, ProcessControlBlock_t *pcb)
+{
+	// the stride may leave a PCB unaligned, so it is copied rather than dereferenced
+	memcpy(pcb, (const uint8_t *)view->base + (view->count - 1 - pid) * view->stride, sizeof(ProcessControlBlock_t));
+}
+
+// private function
+static const SimJob_t *view_cursor_peek(void *source)
+{
+	SimViewCursor_t *cursor = (SimViewCursor_t *)source;
+	if(cursor->next >= cursor->view.count)
+		return NULL;
+
+	size_t pid = cursor->order == NULL ? cursor->next
+									   : (size_t)(*(const uint64_t *)dyn_array_at(cursor->order, cursor->next)
+												  & UINT32_MAX);
+	view_pcb(&cursor->view, pid, &cursor->job.pcb);
+	cursor->job.pid         = pid;
+	cursor->job.burst       = cursor->job.pcb.remaining_burst_time;
+	cursor->job.level       = 0;
+	// nothing has been on the virtual CPU yet, whatever the view says
+	cursor->job.pcb.started = false;
+	return &cursor->job;
+}
+
+// private function
+static void view_cursor_advance(void *source)
+{
+	((SimViewCursor_t *)source)->next++;
+}
+
+bool sim_feed_from_view(SimFeed_t *feed, SimViewCursor_t *cursor, const PcbView_t *view, bool by_arrival)
+{
+	if(feed == NULL || cursor == NULL || view == NULL || view->base == NULL || view->count == 0)
+		return false;
+	if(view->stride < sizeof(ProcessControlBlock_t))
+		return false;
+
+	cursor->view  = *view;
+	cursor->order = NULL;
+	cursor->next  = 0;
+
+	// a view already in arrival order (e.g. as generate_pcbs writes it) only costs a scan
+	ProcessControlBlock_t pcb;
+	uint32_t previous = 0;
+	size_t pid = 0;
+	for(; by_arrival && pid < view->count; pid++)
+	{
+		view_pcb(view, pid, &pcb);
+		if(pcb.arrival < previous)
+			break;
+		previous = pcb.arrival;
+	}
+
+	if(by_arrival && pid < view->count)
+	{
+		// sort 8 byte keys rather than whole jobs, pids have to fit in the low half
+		if(view->count - 1 > UINT32_MAX)
+			return false;
+		cursor->order = dyn_array_create_with_allocator(view->count, sizeof(uint64_t), NULL, sim_scratch_allocator());
+		if(cursor->order == NULL)
+			return false;
+		for(pid = 0; pid < view->count; pid++)
+		{
+			view_pcb(view, pid, &pcb);
+			uint64_t key = (uint64_t)pcb.arrival << 32 | pid;
+			if(!dyn_array_push_back(cursor->order, &key))
+				break;
+		}
+		if(pid < view->count || !dyn_array_sort_by_key(cursor->order, 0, sizeof(uint64_t)))
+		{
+			sim_view_cursor_release(cursor);
+			return false;
+		}
+	}
+
+	feed->peek    = view_cursor_peek;
+	feed->advance = view_cursor_advance;
+	feed->source  = cursor;
+	return true;
+}
+
+void sim_view_cursor_release(SimViewCursor_t *cursor)
+{
+	if(cursor == NULL)
+		return;
+	dyn_array_destroy(cursor->order);
+	cursor->order = NULL;
+}
+
+// private function
+// hands every job whose arrival the clock has reached to the policy, in feed order
+static bool admit_arrivals(const SimFeed_t *feed, size_t *admitted, unsigned long current_time,
+						   const SimPolicy_t *policy)
+{
+	const SimJob_t *next;
+	while((next = feed->peek(feed->source)) != NULL && (unsigned long)next->pcb.arrival <= current_time)
+	{
+		if(!policy->admit(policy->ready_set, next))
+			return false;
+		feed->advance(feed->source);
+		(*admitted)++;
+	}
+	return true;
+}
+
+// private function
+// the event loop itself, recorder only sees events when recording is set
+static bool run_events(const SimFeed_t *feed, const SimPolicy_t *policy, SimRecorder_t *recorder, bool recording,
+					   SimTotals_t *totals)
+{
+	size_t admitted  = 0;
+	size_t completed = 0;
+
+	// 128 bit totals cost an add with carry, and no trace can overflow them
+	ScheduleTotal_t total_waiting_time    = 0;
+	ScheduleTotal_t total_turnaround_time = 0;
+	ScheduleTotal_t total_burst_time      = 0;
+	unsigned long current_time            = 0;
+
+	for(;;)
+	{
+		// admit everything the clock has already reached
+		if(!admit_arrivals(feed, &admitted, current_time, policy))
+			return false;
+
+		if(policy->age != NULL && !policy->age(policy->ready_set, current_time))
+			return false;
+
+		SimJob_t job;
+		if(!policy->select(policy->ready_set, &job))
+		{
+			// an empty ready set with admitted jobs unfinished means the policy lost one
+			if(completed != admitted)
+				return false;
+			// CPU is idle, jump straight to the next arrival, or stop once the feed runs dry
+			const SimJob_t *next = feed->peek(feed->source);
+			if(next == NULL)
+				break;
+			current_time = (unsigned long)next->pcb.arrival;
+			continue;
+		}
+
+		// the slice ends at completion, quantum expiry or the next arrival, whichever is first
+		uint32_t slice = job.pcb.remaining_burst_time;
+		size_t quantum = policy->quantum_of != NULL ? policy->quantum_of(policy->ready_set, &job) : policy->quantum;
+		if(quantum != 0 && quantum < slice)
+			slice = (uint32_t)quantum;
+		bool preempt = policy->preempt_on_arrival_of != NULL ? policy->preempt_on_arrival_of(policy->ready_set, &job)
+															  : policy->preempt_on_arrival;
+		if(preempt)
+		{
+			const SimJob_t *next = feed->peek(feed->source);
+			if(next != NULL)
+			{
+				unsigned long until_arrival = (unsigned long)next->pcb.arrival - current_time;
+				if(until_arrival < slice)
+					slice = (uint32_t)until_arrival;
+			}
+		}
+
+		if(recording && !sim_recorder_slice(recorder, &job, current_time, current_time + slice))
+			return false;
+
+		// waiting time = first dispatch time - arrival time
+		if(!job.pcb.started)
+		{
+			job.pcb.started = true;
+			total_waiting_time += current_time - job.pcb.arrival;
+		}
+
+		virtual_cpu(&job.pcb, slice);
+		current_time += slice;
+
+		// arrivals during the slice queue up ahead of the job being put back
+		if(!admit_arrivals(feed, &admitted, current_time, policy))
+			return false;
+
+		if(job.pcb.remaining_burst_time == 0)
+		{
+			// turnaround time = completion time - arrival time
+			total_turnaround_time += current_time - job.pcb.arrival;
+			total_burst_time      += job.burst;
+			completed++;
+			if(recording)
+				sim_recorder_complete(recorder, &job, current_time);
+			if(policy->retire != NULL && !policy->retire(policy->ready_set, &job))
+				return false;
+		}
+		else if(!policy->requeue(policy->ready_set, &job))
+		{
+			return false;
+		}
+	}
+
+	if(completed == 0)
+		return false;
+
+	totals->response_time   = total_waiting_time;
+	totals->turnaround_time = total_turnaround_time;
+	totals->burst_time      = total_burst_time;
+	totals->num_processes   = completed;
+	totals->run_time        = current_time;
+	return true;
+}
+
+bool sim_run_feed(const SimFeed_t *feed, const SimPolicy_t *policy, const ScheduleOutputs_t *outputs,
+				  ScheduleResult_t *result)
+{
+	// validate inputs
+	if(feed == NULL || policy == NULL || result == NULL)
+		return false;
+	if(feed->peek == NULL || feed->advance == NULL)
+		return false;
+	if(policy->admit == NULL || policy->select == NULL || policy->requeue == NULL)
+		return false;
+
+	SimRecorder_t recorder;
+	if(!sim_recorder_init(&recorder, outputs))
+		return false;
+
+	SimTotals_t totals;
+	bool success = run_events(feed, policy, &recorder, sim_recorder_active(&recorder), &totals);
+	sim_recorder_finish(&recorder, success ? &totals : NULL);
+	if(success)
+		sim_result_from_totals(result, &totals);
+	return success;
+}
+
+bool sim_run(const dyn_array_t *jobs, const SimPolicy_t *policy, ScheduleResult_t *result)
+{
+	SimFeed_t feed;
+	SimJobCursor_t cursor;
+	if(!sim_feed_from_jobs(&feed, &cursor, jobs))
+		return false;
+	return sim_run_feed(&feed, policy, NULL, result);
+}
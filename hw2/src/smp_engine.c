@@ -0,0 +1,299 @@
+#include <stdlib.h>
+
+#include "dyn_heap.h"
+#include "smp_engine.h"
+
+typedef struct
+{
+	SimJob_t job;			// what the core is running, valid while its slice is in slice_ends
+	uint32_t slice;			// length of the slice it is in
+	uint64_t busy_time;
+	size_t slices;
+	size_t steals;
+}
+SmpCore_t;
+
+// a busy core and when its slice ends, the event heap is keyed on these
+typedef struct
+{
+	uint64_t end;
+	size_t core;
+}
+SmpSliceEnd_t;
+
+typedef struct
+{
+	const SimFeed_t *feed;
+	const SimPolicy_t *policies;
+	size_t num_queues;
+	size_t num_cores;
+	SmpCore_t *cores;
+	size_t *queued;			// jobs waiting in each ready set
+	size_t total_queued;
+	size_t *idle;			// stack of idle cores
+	size_t num_idle;
+	size_t *put_back;		// cores whose job goes back to a ready set once this event's arrivals are in
+	size_t num_put_back;
+	dyn_heap_t *slice_ends;	// SmpSliceEnd_t of every busy core, earliest first
+	uint64_t now;
+	size_t admitted;
+	size_t completed;
+	SimTotals_t totals;
+}
+SmpRun_t;
+
+// private function
+// earliest end first, lower core first at the same time so runs are deterministic
+static int compare_slice_end(const void *a, const void *b)
+{
+	const SmpSliceEnd_t *lhs = (const SmpSliceEnd_t *)a;
+	const SmpSliceEnd_t *rhs = (const SmpSliceEnd_t *)b;
+	if(lhs->end != rhs->end)
+		return lhs->end < rhs->end ? -1 : 1;
+	if(lhs->core != rhs->core)
+		return lhs->core < rhs->core ? -1 : 1;
+	return 0;
+}
+
+// private function
+// the ready set a core takes from and gives back to
+static size_t queue_of_core(const SmpRun_t *run, size_t core)
+{
+	return run->num_queues == 1 ? 0 : core;
+}
+
+// private function
+static bool put_in_queue(SmpRun_t *run, size_t queue, const SimJob_t *job, bool arriving)
+{
+	const SimPolicy_t *policy = &run->policies[queue];
+	if(!(arriving ? policy->admit(policy->ready_set, job) : policy->requeue(policy->ready_set, job)))
+		return false;
+	run->queued[queue]++;
+	run->total_queued++;
+	return true;
+}
+
+// private function
+// hands every job whose arrival the clock has reached to a ready set, in feed order
+static bool smp_admit_arrivals(SmpRun_t *run)
+{
+	const SimJob_t *next;
+	while((next = run->feed->peek(run->feed->source)) != NULL && (uint64_t)next->pcb.arrival <= run->now)
+	{
+		if(!put_in_queue(run, run->num_queues == 1 ? 0 : next->pid % run->num_queues, next, true))
+			return false;
+		run->feed->advance(run->feed->source);
+		run->admitted++;
+	}
+	return true;
+}
+
+// private function
+// the per-core queue with the most jobs waiting, the first one on a tie
+static size_t longest_queue(const SmpRun_t *run)
+{
+	size_t longest = 0;
+	for(size_t queue = 1; queue < run->num_queues; queue++)
+	{
+		if(run->queued[queue] > run->queued[longest])
+			longest = queue;
+	}
+	return longest;
+}
+
+// private function
+// puts job on core for one slice, ending at completion, quantum expiry or the next arrival
+static bool start_slice(SmpRun_t *run, size_t core, SimJob_t *job)
+{
+	// waiting time = first dispatch time - arrival time
+	if(!job->pcb.started)
+	{
+		job->pcb.started = true;
+		run->totals.response_time += run->now - job->pcb.arrival;
+	}
+
+	const SimPolicy_t *policy = &run->policies[0];
+	uint32_t slice = job->pcb.remaining_burst_time;
+	if(policy->quantum != 0 && policy->quantum < slice)
+		slice = (uint32_t)policy->quantum;
+	if(policy->preempt_on_arrival)
+	{
+		const SimJob_t *next = run->feed->peek(run->feed->source);
+		if(next != NULL && (uint64_t)next->pcb.arrival - run->now < slice)
+			slice = (uint32_t)((uint64_t)next->pcb.arrival - run->now);
+	}
+
+	SmpCore_t *state = &run->cores[core];
+	state->job   = *job;
+	state->slice = slice;
+	SmpSliceEnd_t end = { run->now + slice, core };
+	return dyn_heap_push(run->slice_ends, &end, NULL);
+}
+
+// private function
+// gives every idle core a job while there are any waiting, stealing for a core whose own queue is empty
+static bool dispatch(SmpRun_t *run)
+{
+	while(run->total_queued > 0 && run->num_idle > 0)
+	{
+		size_t core  = run->idle[--run->num_idle];
+		size_t queue = queue_of_core(run, core);
+		if(run->queued[queue] == 0)
+		{
+			// only per-core queues can run dry while others have work
+			queue = longest_queue(run);
+			run->cores[core].steals++;
+		}
+
+		SimJob_t job;
+		const SimPolicy_t *policy = &run->policies[queue];
+		if(!policy->select(policy->ready_set, &job))
+			return false;
+		run->queued[queue]--;
+		run->total_queued--;
+		if(!start_slice(run, core, &job))
+			return false;
+	}
+	return true;
+}
+
+// private function
+// runs the slice on core to its end, the job either completes or waits to be put back
+static bool finish_slice(SmpRun_t *run, size_t core)
+{
+	SmpCore_t *state = &run->cores[core];
+	state->job.pcb.remaining_burst_time -= state->slice;
+	state->busy_time += state->slice;
+	state->slices++;
+	run->idle[run->num_idle++] = core;
+
+	if(state->job.pcb.remaining_burst_time > 0)
+	{
+		run->put_back[run->num_put_back++] = core;
+		return true;
+	}
+
+	// turnaround time = completion time - arrival time
+	run->totals.turnaround_time += run->now - state->job.pcb.arrival;
+	run->totals.burst_time      += state->job.burst;
+	run->completed++;
+	const SimPolicy_t *policy = &run->policies[queue_of_core(run, core)];
+	return policy->retire == NULL || policy->retire(policy->ready_set, &state->job);
+}
+
+// private function
+static bool smp_events(SmpRun_t *run)
+{
+	for(;;)
+	{
+		if(!smp_admit_arrivals(run))
+			return false;
+
+		// sliced jobs go back behind whatever arrived while they ran
+		for(size_t i = 0; i < run->num_put_back; i++)
+		{
+			size_t core = run->put_back[i];
+			if(!put_in_queue(run, queue_of_core(run, core), &run->cores[core].job, false))
+				return false;
+		}
+		run->num_put_back = 0;
+
+		if(!dispatch(run))
+			return false;
+
+		const SimJob_t *next = run->feed->peek(run->feed->source);
+		if(dyn_heap_empty(run->slice_ends))
+		{
+			// every core is idle with nothing waiting, jump to the next arrival or stop
+			if(next == NULL)
+				break;
+			run->now = next->pcb.arrival;
+			continue;
+		}
+
+		// an arrival only matters before the next slice end if a core is free to take it
+		uint64_t next_end = ((const SmpSliceEnd_t *)dyn_heap_peek(run->slice_ends))->end;
+		if(run->num_idle > 0 && next != NULL && (uint64_t)next->pcb.arrival < next_end)
+		{
+			run->now = next->pcb.arrival;
+			continue;
+		}
+
+		run->now = next_end;
+		while(!dyn_heap_empty(run->slice_ends) && ((const SmpSliceEnd_t *)dyn_heap_peek(run->slice_ends))->end == run->now)
+		{
+			SmpSliceEnd_t end;
+			if(!dyn_heap_extract(run->slice_ends, &end) || !finish_slice(run, end.core))
+				return false;
+		}
+	}
+
+	// anything admitted and never completed was lost by a policy
+	return run->completed > 0 && run->completed == run->admitted;
+}
+
+bool smp_run_feed(const SimFeed_t *feed, const SimPolicy_t *policies, size_t num_queues, size_t num_cores,
+				  SmpCoreStats_t *cores, ScheduleResult_t *result)
+{
+	// validate inputs
+	if(feed == NULL || policies == NULL || result == NULL || num_cores == 0)
+		return false;
+	if(num_queues != 1 && num_queues != num_cores)
+		return false;
+	if(feed->peek == NULL || feed->advance == NULL)
+		return false;
+	for(size_t queue = 0; queue < num_queues; queue++)
+	{
+		const SimPolicy_t *policy = &policies[queue];
+		if(policy->admit == NULL || policy->select == NULL || policy->requeue == NULL)
+			return false;
+		if(policy->quantum != policies[0].quantum || policy->preempt_on_arrival != policies[0].preempt_on_arrival)
+			return false;
+		// per-job quanta, aging and preemption are not simulated across cores yet
+		if(policy->quantum_of != NULL || policy->age != NULL || policy->preempt_on_arrival_of != NULL)
+			return false;
+	}
+
+	SmpRun_t run = { 0 };
+	run.feed       = feed;
+	run.policies   = policies;
+	run.num_queues = num_queues;
+	run.num_cores  = num_cores;
+	run.cores      = calloc(num_cores, sizeof(SmpCore_t));
+	run.queued     = calloc(num_queues, sizeof(size_t));
+	run.idle       = malloc(num_cores * sizeof(size_t));
+	run.put_back   = malloc(num_cores * sizeof(size_t));
+	run.slice_ends = dyn_heap_create(num_cores, sizeof(SmpSliceEnd_t), compare_slice_end, NULL);
+
+	bool success = run.cores != NULL && run.queued != NULL && run.idle != NULL && run.put_back != NULL
+				   && run.slice_ends != NULL;
+	if(success)
+	{
+		// core 0 is the first to be handed work
+		for(size_t core = num_cores; core > 0; core--)
+			run.idle[run.num_idle++] = core - 1;
+		success = smp_events(&run);
+	}
+
+	if(success)
+	{
+		run.totals.num_processes = run.completed;
+		run.totals.run_time      = run.now;
+		sim_result_from_totals(result, &run.totals);
+		for(size_t core = 0; cores != NULL && core < num_cores; core++)
+		{
+			cores[core].busy_time   = run.cores[core].busy_time;
+			cores[core].utilisation = run.now == 0 ? 0.0f
+									: (float)((double)run.cores[core].busy_time / (double)run.now);
+			cores[core].slices      = run.cores[core].slices;
+			cores[core].steals      = run.cores[core].steals;
+		}
+	}
+
+	dyn_heap_destroy(run.slice_ends);
+	free(run.put_back);
+	free(run.idle);
+	free(run.queued);
+	free(run.cores);
+	return success;
+}
@@ -1,13 +1,28 @@
 #include <fcntl.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <pthread.h>
+#include <unistd.h>
+#include <algorithm>
+#include <random>
+#include <vector>
 #include "gtest/gtest.h"
 #include "../include/processing_scheduling.h"
 
 // Using a C library requires extern "C" to prevent function mangling
 extern "C"
 {
+#include <dyn_arena.h>
 #include <dyn_array.h>
+#include <dyn_heap.h>
+#include <dyn_ring.h>
+#include <schedule_batch.h>
+#include <pcb_generator.h>
+#include <pcb_columns.h>
+#include <fcfs_kernel.h>
+#include <schedule_timeline.h>
+#include <latency_histogram.h>
+#include <sim_engine.h>
 }
 
 #define NUM_PCB 30
@@ -24,6 +39,18 @@ ProcessControlBlock_t make_pcb(uint32_t arrival, uint32_t burst) {
     return pcb;
 }
 
+int compare_int(const void* a, const void* b) {
+    int lhs = *(const int*)a;
+    int rhs = *(const int*)b;
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+int destructed_ints = 0;
+void count_destruct(void* object) {
+    (void)object;
+    ++destructed_ints;
+}
+
 /*
 Test 1:
 Basic FCFS ordering with two processes arriving at time 0
@@ -141,6 +168,1650 @@ TEST(LoadPCB_Test, ValidFileLoadsCorrectly)
     dyn_array_destroy(pcbs);
     remove(input_filename);
 }
+/*
+Test 5:
+Huge bursts are simulated by jumping the clock, not by ticking it
+*/
+TEST(FCFS_Test, HugeBurstsJumpClock) {
+    dyn_array_t* queue = dyn_array_create(0, sizeof(ProcessControlBlock_t), nullptr);
+    ScheduleResult_t result;
+
+    ProcessControlBlock_t second = make_pcb(0, 2000000000u);
+    ProcessControlBlock_t first  = make_pcb(0, 2000000000u);
+
+    dyn_array_push_back(queue, &second);
+    dyn_array_push_back(queue, &first);
+
+    ASSERT_TRUE(first_come_first_serve(queue, &result));
+
+    EXPECT_EQ(result.total_run_time, 4000000000UL);
+    EXPECT_FLOAT_EQ(result.average_waiting_time, 1000000000.0f);
+    EXPECT_FLOAT_EQ(result.average_turnaround_time, 3000000000.0f);
+    EXPECT_TRUE(dyn_array_empty(queue));
+
+    dyn_array_destroy(queue);
+}
+
+/*
+Test 6:
+FCFS follows queue order even when a later entry arrived earlier
+*/
+TEST(FCFS_Test, QueueOrderNotArrivalOrder) {
+    dyn_array_t* queue = dyn_array_create(0, sizeof(ProcessControlBlock_t), nullptr);
+    ScheduleResult_t result;
+
+    ProcessControlBlock_t second = make_pcb(2, 4); // arrived earlier but queued second
+    ProcessControlBlock_t first  = make_pcb(6, 3);
+
+    dyn_array_push_back(queue, &second);
+    dyn_array_push_back(queue, &first);
+
+    ASSERT_TRUE(first_come_first_serve(queue, &result));
+
+    //first runs 6..9, second waits until 9 and runs 9..13
+    EXPECT_FLOAT_EQ(result.average_waiting_time, 3.5f);
+    EXPECT_FLOAT_EQ(result.average_turnaround_time, 7.0f);
+    EXPECT_EQ(result.total_run_time, 13UL);
+
+    dyn_array_destroy(queue);
+}
+
+/*
+Test 7:
+Header promising more records than the file holds is rejected
+*/
+TEST(LoadPCB_Test, TruncatedFileRejected)
+{
+    const char* input_filename = "/tmp/test_truncated_pcb.bin";
+
+    FILE* f = fopen(input_filename, "wb");
+    ASSERT_NE(f, (FILE*)NULL);
+
+    // claims 3 entries but only holds one and a half
+    uint32_t data[] = {3, 5, 1, 0, 3, 2};
+    fwrite(data, sizeof(uint32_t), 6, f);
+    fclose(f);
+
+    dyn_array_t* pcbs = load_process_control_blocks(input_filename);
+    EXPECT_EQ(pcbs, (dyn_array_t*)NULL);
+
+    remove(input_filename);
+}
+
+/*
+Test 8:
+SJF picks the shortest arrived burst each time the CPU frees up
+*/
+TEST(SJF_Test, ShortestArrivedBurstRunsNext) {
+    dyn_array_t* queue = dyn_array_create(0, sizeof(ProcessControlBlock_t), nullptr);
+    ScheduleResult_t result;
+
+    ProcessControlBlock_t pcbs[] = { make_pcb(5, 4), make_pcb(4, 1), make_pcb(2, 4), make_pcb(0, 7) };
+    for (ProcessControlBlock_t& pcb : pcbs)
+        dyn_array_push_back(queue, &pcb);
+
+    ASSERT_TRUE(shortest_job_first(queue, &result));
+
+    //runs 0..7 (arr 0), 7..8 (arr 4), 8..12 (arr 2), 12..16 (arr 5)
+    //waiting: 0 + 3 + 6 + 7 = 16, turnaround: 7 + 4 + 10 + 11 = 32
+    EXPECT_FLOAT_EQ(result.average_waiting_time, 4.0f);
+    EXPECT_FLOAT_EQ(result.average_turnaround_time, 8.0f);
+    EXPECT_EQ(result.total_run_time, 16UL);
+
+    dyn_array_destroy(queue);
+}
+
+/*
+Test 9:
+Equal bursts fall back to arrival order, and bad input is rejected
+*/
+TEST(SJF_Test, TieBreaksOnArrival) {
+    dyn_array_t* queue = dyn_array_create(0, sizeof(ProcessControlBlock_t), nullptr);
+    ScheduleResult_t result;
+
+    EXPECT_FALSE(shortest_job_first(nullptr, &result));
+    EXPECT_FALSE(shortest_job_first(queue, &result));
+
+    ProcessControlBlock_t pcbs[] = { make_pcb(2, 3), make_pcb(1, 3), make_pcb(0, 5) };
+    for (ProcessControlBlock_t& pcb : pcbs)
+        dyn_array_push_back(queue, &pcb);
+
+    ASSERT_TRUE(shortest_job_first(queue, &result));
+
+    //runs 0..5 (arr 0), 5..8 (arr 1), 8..11 (arr 2)
+    EXPECT_FLOAT_EQ(result.average_waiting_time, 10.0f / 3.0f);
+    EXPECT_FLOAT_EQ(result.average_turnaround_time, 7.0f);
+    EXPECT_EQ(result.total_run_time, 11UL);
+
+    dyn_array_destroy(queue);
+}
+
+/*
+Test 10:
+Heap hands objects back smallest first, across growth past the initial capacity
+*/
+TEST(DynHeap_Test, ExtractsInOrder)
+{
+    dyn_heap_t* heap = dyn_heap_create(0, sizeof(int), compare_int, nullptr);
+    ASSERT_NE(heap, (dyn_heap_t*)NULL);
+
+    for (int i = 0; i < 100; ++i) {
+        int value = (i * 37) % 100;
+        ASSERT_TRUE(dyn_heap_push(heap, &value, nullptr));
+    }
+    EXPECT_EQ(dyn_heap_size(heap), (size_t)100);
+    EXPECT_EQ(*(int*)dyn_heap_peek(heap), 0);
+
+    for (int i = 0; i < 100; ++i) {
+        int value = -1;
+        ASSERT_TRUE(dyn_heap_extract(heap, &value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_TRUE(dyn_heap_empty(heap));
+    EXPECT_FALSE(dyn_heap_pop(heap));
+    EXPECT_EQ(dyn_heap_peek(heap), (void*)NULL);
+
+    dyn_heap_destroy(heap);
+}
+
+/*
+Test 11:
+Decrease-key moves an object forward, handles go stale once the object leaves
+*/
+TEST(DynHeap_Test, DecreaseKeyAndHandles)
+{
+    destructed_ints = 0;
+    dyn_heap_t* heap = dyn_heap_create(4, sizeof(int), compare_int, count_destruct);
+    ASSERT_NE(heap, (dyn_heap_t*)NULL);
+
+    size_t handles[5];
+    int values[5] = {50, 40, 30, 20, 10};
+    for (int i = 0; i < 5; ++i)
+        ASSERT_TRUE(dyn_heap_push(heap, &values[i], &handles[i]));
+
+    int smaller = 5;
+    ASSERT_TRUE(dyn_heap_decrease_key(heap, handles[0], &smaller));
+    size_t top;
+    ASSERT_TRUE(dyn_heap_peek_handle(heap, &top));
+    EXPECT_EQ(top, handles[0]);
+    EXPECT_EQ(*(int*)dyn_heap_at(heap, handles[0]), 5);
+
+    // increases are refused and leave the object alone
+    int bigger = 99;
+    EXPECT_FALSE(dyn_heap_decrease_key(heap, handles[4], &bigger));
+    EXPECT_EQ(*(int*)dyn_heap_at(heap, handles[4]), 10);
+
+    ASSERT_TRUE(dyn_heap_pop(heap));
+    EXPECT_EQ(destructed_ints, 1);
+    EXPECT_EQ(dyn_heap_at(heap, handles[0]), (void*)NULL);
+    EXPECT_FALSE(dyn_heap_decrease_key(heap, handles[0], &smaller));
+
+    // the freed handle is recycled for the next push
+    size_t recycled;
+    int value = 1;
+    ASSERT_TRUE(dyn_heap_push(heap, &value, &recycled));
+    EXPECT_EQ(recycled, handles[0]);
+
+    dyn_heap_destroy(heap);
+    EXPECT_EQ(destructed_ints, 6);
+}
+
+/*
+Test 12:
+SRTF preempts only when an arrival has less work left than the running process
+*/
+TEST(SRTF_Test, PreemptsOnShorterArrival) {
+    dyn_array_t* queue = dyn_array_create(0, sizeof(ProcessControlBlock_t), nullptr);
+    ScheduleResult_t result;
+
+    ProcessControlBlock_t pcbs[] = { make_pcb(3, 5), make_pcb(2, 9), make_pcb(1, 4), make_pcb(0, 8) };
+    for (ProcessControlBlock_t& pcb : pcbs)
+        dyn_array_push_back(queue, &pcb);
+
+    ASSERT_TRUE(shortest_remaining_time_first(queue, &result));
+
+    //runs 0..1 (arr 0), 1..5 (arr 1), 5..10 (arr 3), 10..17 (arr 0), 17..26 (arr 2)
+    //waiting until first dispatch: 0 + 0 + 2 + 15 = 17
+    //turnaround: 17 + 4 + 7 + 24 = 52
+    EXPECT_FLOAT_EQ(result.average_waiting_time, 4.25f);
+    EXPECT_FLOAT_EQ(result.average_turnaround_time, 13.0f);
+    EXPECT_EQ(result.total_run_time, 26UL);
+    EXPECT_TRUE(dyn_array_empty(queue));
+
+    dyn_array_destroy(queue);
+}
+
+/*
+Test 13:
+A process finishing at the same instant a shorter one arrives is retired, not the newcomer
+*/
+TEST(SRTF_Test, CompletionAtArrivalInstant) {
+    dyn_array_t* queue = dyn_array_create(0, sizeof(ProcessControlBlock_t), nullptr);
+    ScheduleResult_t result;
+
+    ProcessControlBlock_t pcbs[] = { make_pcb(4, 1), make_pcb(0, 4), make_pcb(0, 6) };
+    for (ProcessControlBlock_t& pcb : pcbs)
+        dyn_array_push_back(queue, &pcb);
+
+    ASSERT_TRUE(shortest_remaining_time_first(queue, &result));
+
+    //runs 0..4 (burst 4), 4..5 (arr 4), 5..11 (burst 6)
+    //waiting: 0 + 0 + 5 = 5, turnaround: 4 + 1 + 11 = 16
+    EXPECT_FLOAT_EQ(result.average_waiting_time, 5.0f / 3.0f);
+    EXPECT_FLOAT_EQ(result.average_turnaround_time, 16.0f / 3.0f);
+    EXPECT_EQ(result.total_run_time, 11UL);
+
+    dyn_array_destroy(queue);
+}
+
+/*
+Test 14:
+Ring keeps deque order while wrapping around and growing
+*/
+TEST(DynRing_Test, WrapsAndGrows)
+{
+    dyn_ring_t* ring = dyn_ring_create(0, sizeof(int), nullptr);
+    ASSERT_NE(ring, (dyn_ring_t*)NULL);
+    size_t capacity = dyn_ring_capacity(ring);
+
+    // walk the head around the ring so the contents wrap
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_TRUE(dyn_ring_push_back(ring, &i));
+        ASSERT_TRUE(dyn_ring_pop_front(ring));
+    }
+    for (int i = 0; i < (int)capacity; ++i)
+        ASSERT_TRUE(dyn_ring_push_back(ring, &i));
+    int before = -1;
+    ASSERT_TRUE(dyn_ring_push_front(ring, &before));
+    EXPECT_GT(dyn_ring_capacity(ring), capacity);
+
+    EXPECT_EQ(*(int*)dyn_ring_front(ring), -1);
+    EXPECT_EQ(*(int*)dyn_ring_back(ring), (int)capacity - 1);
+    for (int i = 0; i < (int)capacity; ++i)
+        EXPECT_EQ(*(int*)dyn_ring_at(ring, (size_t)i + 1), i);
+
+    int value;
+    ASSERT_TRUE(dyn_ring_extract_back(ring, &value));
+    EXPECT_EQ(value, (int)capacity - 1);
+    ASSERT_TRUE(dyn_ring_extract_front(ring, &value));
+    EXPECT_EQ(value, -1);
+    EXPECT_EQ(dyn_ring_size(ring), capacity - 1);
+
+    dyn_ring_destroy(ring);
+}
+
+/*
+Test 15:
+RR slices by quantum, and arrivals during a slice queue ahead of the preempted process
+*/
+TEST(RR_Test, SlicesByQuantum) {
+    dyn_array_t* queue = dyn_array_create(0, sizeof(ProcessControlBlock_t), nullptr);
+    ScheduleResult_t result;
+
+    EXPECT_FALSE(round_robin(queue, &result, 2));
+
+    ProcessControlBlock_t pcbs[] = { make_pcb(2, 1), make_pcb(1, 3), make_pcb(0, 5) };
+    for (ProcessControlBlock_t& pcb : pcbs)
+        dyn_array_push_back(queue, &pcb);
+
+    EXPECT_FALSE(round_robin(queue, &result, 0));
+    ASSERT_TRUE(round_robin(queue, &result, 2));
+
+    //0..2 (arr 0), 2..4 (arr 1), 4..5 (arr 2), 5..7 (arr 0), 7..8 (arr 1), 8..9 (arr 0)
+    //waiting until first dispatch: 0 + 1 + 2 = 3
+    //turnaround: 9 + 7 + 3 = 19
+    EXPECT_FLOAT_EQ(result.average_waiting_time, 1.0f);
+    EXPECT_FLOAT_EQ(result.average_turnaround_time, 19.0f / 3.0f);
+    EXPECT_EQ(result.total_run_time, 9UL);
+
+    dyn_array_destroy(queue);
+}
+
+/*
+Test 16:
+A tiny quantum over long bursts stays linear in the number of slices
+*/
+TEST(RR_Test, TinyQuantumLongBursts) {
+    dyn_array_t* queue = dyn_array_create(0, sizeof(ProcessControlBlock_t), nullptr);
+    ScheduleResult_t result;
+
+    ProcessControlBlock_t pcbs[] = { make_pcb(0, 300000), make_pcb(0, 200000), make_pcb(0, 100000) };
+    for (ProcessControlBlock_t& pcb : pcbs)
+        dyn_array_push_back(queue, &pcb);
+
+    ASSERT_TRUE(round_robin(queue, &result, 1));
+
+    //first dispatches at 0, 1, 2
+    //finishes at 299998, 499999, 600000
+    EXPECT_FLOAT_EQ(result.average_waiting_time, 1.0f);
+    EXPECT_FLOAT_EQ(result.average_turnaround_time, 1399997.0f / 3.0f);
+    EXPECT_EQ(result.total_run_time, 600000UL);
+
+    dyn_array_destroy(queue);
+}
+
+/*
+Test 17:
+Batch specifications parse into requests in order
+*/
+TEST(Batch_Test, ParsesSpecifications)
+{
+    dyn_array_t* requests = schedule_batch_parse("ALL", 3);
+    ASSERT_NE(requests, (dyn_array_t*)NULL);
+    ASSERT_EQ(dyn_array_size(requests), (size_t)5);
+    const ScheduleRequest_t* rr = (const ScheduleRequest_t*)dyn_array_at(requests, 3);
+    EXPECT_EQ(rr->algorithm, SCHEDULE_RR);
+    EXPECT_EQ(rr->quantum, (size_t)3);
+    EXPECT_STREQ(rr->name, "RR:3");
+    dyn_array_destroy(requests);
+
+    requests = schedule_batch_parse("SRT,RR:4,FCFS", 0);
+    ASSERT_NE(requests, (dyn_array_t*)NULL);
+    ASSERT_EQ(dyn_array_size(requests), (size_t)3);
+    EXPECT_EQ(((const ScheduleRequest_t*)dyn_array_at(requests, 0))->algorithm, SCHEDULE_SRTF);
+    EXPECT_EQ(((const ScheduleRequest_t*)dyn_array_at(requests, 1))->quantum, (size_t)4);
+    EXPECT_EQ(((const ScheduleRequest_t*)dyn_array_at(requests, 2))->algorithm, SCHEDULE_FCFS);
+    dyn_array_destroy(requests);
+
+    // ALL falls back to its own quantum for RR
+    requests = schedule_batch_parse("ALL", 0);
+    ASSERT_NE(requests, (dyn_array_t*)NULL);
+    ASSERT_EQ(dyn_array_size(requests), (size_t)5);
+    rr = (const ScheduleRequest_t*)dyn_array_at(requests, 3);
+    EXPECT_EQ(rr->quantum, (size_t)SCHEDULE_ALL_QUANTUM);
+    EXPECT_STREQ(rr->name, "RR:4");
+    dyn_array_destroy(requests);
+
+    // a list still needs a quantum for plain RR, and unknown names are rejected
+    EXPECT_EQ(schedule_batch_parse("FCFS,RR", 0), (dyn_array_t*)NULL);
+    EXPECT_EQ(schedule_batch_parse("FCFS,,SJF", 0), (dyn_array_t*)NULL);
+    EXPECT_EQ(schedule_batch_parse("FCFS,LOTTERY", 0), (dyn_array_t*)NULL);
+}
+
+/*
+Test 18:
+Batch runs give every scheduler its own copy and leave the input intact
+*/
+TEST(Batch_Test, RunsEachOnItsOwnCopy)
+{
+    dyn_array_t* queue = dyn_array_create(0, sizeof(ProcessControlBlock_t), nullptr);
+    ProcessControlBlock_t pcbs[] = { make_pcb(3, 5), make_pcb(2, 9), make_pcb(1, 4), make_pcb(0, 8) };
+    for (ProcessControlBlock_t& pcb : pcbs)
+        dyn_array_push_back(queue, &pcb);
+
+    dyn_array_t* requests = schedule_batch_parse("FCFS,SRT,FCFS", 0);
+    dyn_array_t* runs = schedule_batch_run(queue, requests, 2);
+    ASSERT_NE(runs, (dyn_array_t*)NULL);
+    ASSERT_EQ(dyn_array_size(runs), (size_t)3);
+    EXPECT_EQ(dyn_array_size(queue), (size_t)4);
+
+    const ScheduleRun_t* first  = (const ScheduleRun_t*)dyn_array_at(runs, 0);
+    const ScheduleRun_t* srtf   = (const ScheduleRun_t*)dyn_array_at(runs, 1);
+    const ScheduleRun_t* second = (const ScheduleRun_t*)dyn_array_at(runs, 2);
+    ASSERT_TRUE(first->success && srtf->success && second->success);
+    EXPECT_FLOAT_EQ(srtf->result.average_turnaround_time, 13.0f);
+    EXPECT_FLOAT_EQ(first->result.average_waiting_time, second->result.average_waiting_time);
+    EXPECT_EQ(first->result.total_run_time, second->result.total_run_time);
+
+    dyn_array_destroy(runs);
+    dyn_array_destroy(requests);
+    dyn_array_destroy(queue);
+}
+
+void record_quantum(const ScheduleRun_t* run, void* context) {
+    std::vector<size_t>* seen = (std::vector<size_t>*)context;
+    seen->push_back(run->request.quantum);
+}
+
+/*
+Test 19:
+Quantum sweeps parse into one RR request per quantum and stream results in quantum order
+*/
+TEST(Batch_Test, QuantumSweepStreamsInOrder)
+{
+    dyn_array_t* requests = schedule_sweep_parse("1:10:3");
+    ASSERT_NE(requests, (dyn_array_t*)NULL);
+    ASSERT_EQ(dyn_array_size(requests), (size_t)4);
+    EXPECT_EQ(((const ScheduleRequest_t*)dyn_array_at(requests, 3))->quantum, (size_t)10);
+
+    EXPECT_EQ(schedule_sweep_parse("0:4"), (dyn_array_t*)NULL);
+    EXPECT_EQ(schedule_sweep_parse("5:4"), (dyn_array_t*)NULL);
+    EXPECT_EQ(schedule_sweep_parse("1:4:0"), (dyn_array_t*)NULL);
+    EXPECT_EQ(schedule_sweep_parse("1:-4"), (dyn_array_t*)NULL);
+    EXPECT_EQ(schedule_sweep_parse("4"), (dyn_array_t*)NULL);
+
+    dyn_array_t* queue = dyn_array_create(0, sizeof(ProcessControlBlock_t), nullptr);
+    ProcessControlBlock_t pcbs[] = { make_pcb(2, 1), make_pcb(1, 3), make_pcb(0, 5) };
+    for (ProcessControlBlock_t& pcb : pcbs)
+        dyn_array_push_back(queue, &pcb);
+
+    std::vector<size_t> seen;
+    dyn_array_t* runs = schedule_sweep_run(queue, requests, 3, record_quantum, &seen);
+    ASSERT_NE(runs, (dyn_array_t*)NULL);
+    EXPECT_EQ(seen, (std::vector<size_t>{1, 4, 7, 10}));
+    EXPECT_EQ(dyn_array_size(queue), (size_t)3);
+
+    // quantum 1 matches a plain round robin run on an unsorted copy
+    ScheduleResult_t direct;
+    ASSERT_TRUE(round_robin(queue, &direct, 1));
+    const ScheduleRun_t* swept = (const ScheduleRun_t*)dyn_array_at(runs, 0);
+    ASSERT_TRUE(swept->success);
+    EXPECT_FLOAT_EQ(swept->result.average_waiting_time, direct.average_waiting_time);
+    EXPECT_FLOAT_EQ(swept->result.average_turnaround_time, direct.average_turnaround_time);
+    EXPECT_EQ(swept->result.total_run_time, direct.total_run_time);
+
+    dyn_array_destroy(runs);
+    dyn_array_destroy(requests);
+    dyn_array_destroy(queue);
+}
+
+/*
+Test 20:
+Generated traces load back in arrival order and are reproducible from the seed
+*/
+TEST(Generator_Test, WritesLoadableSeededTraces)
+{
+    const char* first_file  = "/tmp/test_generated_a.bin";
+    const char* second_file = "/tmp/test_generated_b.bin";
+
+    PcbGeneratorConfig_t config;
+    pcb_generator_defaults(&config, 10000, 7);
+    config.arrivals = ARRIVALS_STORM;
+    config.bursts   = BURSTS_PARETO;
+    ASSERT_TRUE(pcb_generate_file(first_file, &config));
+    ASSERT_TRUE(pcb_generate_file(second_file, &config));
+
+    dyn_array_t* first  = load_process_control_blocks(first_file);
+    dyn_array_t* second = load_process_control_blocks(second_file);
+    ASSERT_NE(first, (dyn_array_t*)NULL);
+    ASSERT_NE(second, (dyn_array_t*)NULL);
+    ASSERT_EQ(dyn_array_size(first), (size_t)10000);
+    EXPECT_EQ(memcmp(dyn_array_export(first), dyn_array_export(second), 10000 * sizeof(ProcessControlBlock_t)), 0);
+
+    // back of the queue is the first record, arrivals never go backwards
+    uint32_t last_arrival = 0;
+    for (size_t i = dyn_array_size(first); i > 0; --i) {
+        const ProcessControlBlock_t* pcb = (const ProcessControlBlock_t*)dyn_array_at(first, i - 1);
+        EXPECT_GE(pcb->arrival, last_arrival);
+        EXPECT_GE(pcb->remaining_burst_time, (uint32_t)1);
+        EXPECT_LT(pcb->priority, config.priority_levels);
+        last_arrival = pcb->arrival;
+    }
+
+    // bad settings are refused and leave no file behind
+    config.pareto_alpha = 1.0;
+    EXPECT_FALSE(pcb_generate_file(first_file, &config));
+    EXPECT_EQ(fopen(first_file, "rb"), (FILE*)NULL);
+
+    dyn_array_destroy(first);
+    dyn_array_destroy(second);
+    remove(second_file);
+}
+
+/*
+Test 21:
+Streaming straight from the file gives the same results as loading it first
+*/
+TEST(Stream_Test, MatchesLoadedSchedulers)
+{
+    const char* input_filename = "/tmp/test_stream_pcb.bin";
+
+    // several stream blocks, with storms so the ready set actually fills up
+    PcbGeneratorConfig_t config;
+    pcb_generator_defaults(&config, 20000, 3);
+    config.arrivals = ARRIVALS_STORM;
+    config.bursts   = BURSTS_EXPONENTIAL;
+    ASSERT_TRUE(pcb_generate_file(input_filename, &config));
+
+    for (int algorithm = 0; algorithm < 4; ++algorithm) {
+        dyn_array_t* queue = load_process_control_blocks(input_filename);
+        pcb_stream_t* stream = pcb_stream_open(input_filename);
+        ASSERT_NE(queue, (dyn_array_t*)NULL);
+        ASSERT_NE(stream, (pcb_stream_t*)NULL);
+
+        ScheduleResult_t loaded, streamed;
+        switch (algorithm) {
+            case 0:
+                ASSERT_TRUE(first_come_first_serve(queue, &loaded));
+                ASSERT_TRUE(first_come_first_serve_stream(stream, &streamed, NULL));
+                break;
+            case 1:
+                ASSERT_TRUE(shortest_job_first(queue, &loaded));
+                ASSERT_TRUE(shortest_job_first_stream(stream, &streamed, NULL));
+                break;
+            case 2:
+                ASSERT_TRUE(round_robin(queue, &loaded, 7));
+                ASSERT_TRUE(round_robin_stream(stream, &streamed, 7, NULL));
+                break;
+            default:
+                ASSERT_TRUE(shortest_remaining_time_first(queue, &loaded));
+                ASSERT_TRUE(shortest_remaining_time_first_stream(stream, &streamed, NULL));
+                break;
+        }
+        EXPECT_EQ(streamed.average_waiting_time, loaded.average_waiting_time) << "algorithm " << algorithm;
+        EXPECT_EQ(streamed.average_turnaround_time, loaded.average_turnaround_time) << "algorithm " << algorithm;
+        EXPECT_EQ(streamed.total_run_time, loaded.total_run_time) << "algorithm " << algorithm;
+
+        pcb_stream_close(stream);
+        dyn_array_destroy(queue);
+    }
+    remove(input_filename);
+}
+
+/*
+Test 22:
+FCFS streams a file in any order, the sorting policies refuse one whose arrivals go backwards
+*/
+TEST(Stream_Test, ArrivalOrderAndTruncation)
+{
+    const char* input_filename = "/tmp/test_stream_unordered.bin";
+    uint32_t data[] = {4, 5, 0, 6, 3, 0, 2, 2, 0, 0, 4, 0, 3};
+    FILE* f = fopen(input_filename, "wb");
+    ASSERT_NE(f, (FILE*)NULL);
+    fwrite(data, sizeof(uint32_t), 13, f);
+    fclose(f);
+
+    dyn_array_t* queue = load_process_control_blocks(input_filename);
+    ASSERT_NE(queue, (dyn_array_t*)NULL);
+    ScheduleResult_t loaded, streamed;
+    ASSERT_TRUE(first_come_first_serve(queue, &loaded));
+
+    pcb_stream_t* stream = pcb_stream_open(input_filename);
+    ASSERT_TRUE(first_come_first_serve_stream(stream, &streamed, NULL));
+    EXPECT_EQ(streamed.average_waiting_time, loaded.average_waiting_time);
+    EXPECT_EQ(streamed.average_turnaround_time, loaded.average_turnaround_time);
+    EXPECT_EQ(streamed.total_run_time, loaded.total_run_time);
+    pcb_stream_close(stream);
+
+    stream = pcb_stream_open(input_filename);
+    EXPECT_FALSE(shortest_job_first_stream(stream, &streamed, NULL));
+    pcb_stream_close(stream);
+
+    // a header that promises more records than the file holds is refused up front
+    data[0] = 5;
+    f = fopen(input_filename, "wb");
+    ASSERT_NE(f, (FILE*)NULL);
+    fwrite(data, sizeof(uint32_t), 13, f);
+    fclose(f);
+    EXPECT_EQ(pcb_stream_open(input_filename), (pcb_stream_t*)NULL);
+
+    dyn_array_destroy(queue);
+    remove(input_filename);
+}
+
+/*
+Test 23:
+Columns come out in dispatch order and the FCFS kernel over them gives the same totals as the scheduler
+*/
+TEST(Columns_Test, SplitsQueueAndReduces)
+{
+    dyn_array_t* queue = dyn_array_create(0, sizeof(ProcessControlBlock_t), nullptr);
+
+    // back of the queue runs first: arrivals 0, 1, 2 with bursts 4, 3, 5
+    ProcessControlBlock_t pcbs[] = { make_pcb(2, 5), make_pcb(1, 3), make_pcb(0, 4) };
+    for (ProcessControlBlock_t& pcb : pcbs) {
+        pcb.priority = pcb.arrival + 10;
+        pcb.started = false;
+        dyn_array_push_back(queue, &pcb);
+    }
+
+    PcbColumns_t* columns = pcb_columns_from_queue(queue);
+    ASSERT_NE(columns, (PcbColumns_t*)NULL);
+    ASSERT_EQ(columns->size, (size_t)3);
+    EXPECT_EQ(dyn_array_size(queue), (size_t)3);
+    for (size_t i = 0; i < 3; ++i) {
+        EXPECT_EQ(columns->arrival[i], (uint32_t)i);
+        EXPECT_EQ(columns->priority[i], (uint32_t)(i + 10));
+        EXPECT_FALSE(columns->started[i]);
+        EXPECT_EQ((uintptr_t)columns->arrival % 64, (uintptr_t)0);
+    }
+
+    // FCFS dispatches at 0, 4 and 7, finishing at 4, 7 and 12
+    FcfsTotals_t totals;
+    ASSERT_TRUE(fcfs_kernel_run(FCFS_KERNEL_SCALAR, columns, &totals));
+    EXPECT_TRUE(totals.total_waiting_time == 8);
+    EXPECT_TRUE(totals.total_turnaround_time == 20);
+    EXPECT_EQ(totals.total_run_time, (uint64_t)12);
+
+    ScheduleResult_t result;
+    ASSERT_TRUE(first_come_first_serve(queue, &result));
+    EXPECT_FLOAT_EQ(result.average_waiting_time, 8.0f / 3.0f);
+    EXPECT_FLOAT_EQ(result.average_turnaround_time, 20.0f / 3.0f);
+
+    EXPECT_EQ(pcb_columns_from_queue(queue), (PcbColumns_t*)NULL);
+    pcb_columns_destroy(columns);
+    dyn_array_destroy(queue);
+}
+
+/*
+Test 24:
+Every FCFS kernel this CPU supports gives exactly the totals of the event loop
+*/
+TEST(FCFS_Test, KernelsMatchEventLoop)
+{
+    const char* input_filename = "/tmp/test_fcfs_kernel.bin";
+
+    // an odd count so the vector kernels finish on a scalar tail, and idle gaps from the storms
+    PcbGeneratorConfig_t config;
+    pcb_generator_defaults(&config, 10007, 11);
+    config.arrivals = ARRIVALS_STORM;
+    config.bursts   = BURSTS_PARETO;
+    ASSERT_TRUE(pcb_generate_file(input_filename, &config));
+
+    dyn_array_t* queue = load_process_control_blocks(input_filename);
+    ASSERT_NE(queue, (dyn_array_t*)NULL);
+    PcbColumns_t* columns = pcb_columns_from_queue(queue);
+    ASSERT_NE(columns, (PcbColumns_t*)NULL);
+
+    FcfsTotals_t scalar;
+    ASSERT_TRUE(fcfs_kernel_run(FCFS_KERNEL_SCALAR, columns, &scalar));
+    const FcfsKernel_t kernels[] = { FCFS_KERNEL_AVX512 };
+    for (FcfsKernel_t kernel : kernels) {
+        FcfsTotals_t vector;
+        if (!fcfs_kernel_supported(kernel)) {
+            EXPECT_FALSE(fcfs_kernel_run(kernel, columns, &vector));
+            continue;
+        }
+        ASSERT_TRUE(fcfs_kernel_run(kernel, columns, &vector));
+        EXPECT_EQ(vector.total_waiting_time, scalar.total_waiting_time) << "kernel " << kernel;
+        EXPECT_EQ(vector.total_turnaround_time, scalar.total_turnaround_time) << "kernel " << kernel;
+        EXPECT_EQ(vector.total_run_time, scalar.total_run_time) << "kernel " << kernel;
+    }
+
+    // fed in uneven blocks, every kernel carries on exactly where the last block left off
+    const FcfsKernel_t all[] = { FCFS_KERNEL_SCALAR, FCFS_KERNEL_AVX512 };
+    for (FcfsKernel_t kernel : all) {
+        if (!fcfs_kernel_supported(kernel))
+            continue;
+        FcfsTotals_t blocked = { 0, 0, 0 };
+        for (size_t i = 0, step = 1; i < columns->size; i += step, step = step * 3 + 5) {
+            size_t count = std::min(step, columns->size - i);
+            ASSERT_TRUE(fcfs_kernel_resume(kernel, columns->burst + i, columns->arrival + i, count, &blocked));
+        }
+        EXPECT_TRUE(blocked.total_waiting_time == scalar.total_waiting_time) << "kernel " << kernel;
+        EXPECT_TRUE(blocked.total_turnaround_time == scalar.total_turnaround_time) << "kernel " << kernel;
+        EXPECT_EQ(blocked.total_run_time, scalar.total_run_time) << "kernel " << kernel;
+    }
+
+    // the streaming FCFS still runs the event loop
+    ScheduleResult_t loaded, streamed;
+    ASSERT_TRUE(first_come_first_serve(queue, &loaded));
+    EXPECT_TRUE(dyn_array_empty(queue));
+    pcb_stream_t* stream = pcb_stream_open(input_filename);
+    ASSERT_TRUE(first_come_first_serve_stream(stream, &streamed, NULL));
+    EXPECT_EQ(loaded.average_waiting_time, streamed.average_waiting_time);
+    EXPECT_EQ(loaded.average_turnaround_time, streamed.average_turnaround_time);
+    EXPECT_EQ(loaded.total_run_time, streamed.total_run_time);
+    EXPECT_EQ(loaded.total_run_time, scalar.total_run_time);
+
+    pcb_stream_close(stream);
+    pcb_columns_destroy(columns);
+    dyn_array_destroy(queue);
+    remove(input_filename);
+}
+
+/*
+Test 25:
+Round robin hands every slice to the timeline, and a full buffer fails the run
+*/
+TEST(Timeline_Test, RoundRobinSlices)
+{
+    dyn_array_t* queue = dyn_array_create(0, sizeof(ProcessControlBlock_t), nullptr);
+    ScheduleResult_t with, without;
+
+    // pid 0 arrives at 0 with 5, pid 1 arrives at 1 with 3
+    ProcessControlBlock_t second = make_pcb(1, 3);
+    ProcessControlBlock_t first  = make_pcb(0, 5);
+    dyn_array_push_back(queue, &second);
+    dyn_array_push_back(queue, &first);
+    dyn_array_t* copy = dyn_array_import(dyn_array_export(queue), 2, sizeof(ProcessControlBlock_t), nullptr);
+
+    ScheduleSlice_t slices[8];
+    ScheduleTimeline_t timeline;
+    ScheduleTimelineBuffer_t buffer;
+    ScheduleOutputs_t outputs = { &timeline, NULL };
+    ASSERT_TRUE(schedule_timeline_to_buffer(&timeline, &buffer, slices, 8));
+    ASSERT_TRUE(round_robin_detailed(queue, &with, 2, &outputs));
+    ASSERT_TRUE(round_robin(copy, &without, 2));
+    EXPECT_EQ(with.average_waiting_time, without.average_waiting_time);
+    EXPECT_EQ(with.average_turnaround_time, without.average_turnaround_time);
+
+    // 0 runs 0..2, 1 runs 2..4, 0 runs 4..6, 1 runs 6..7, 0 runs 7..8
+    const ScheduleSlice_t expected[] = { {0, 0, 2}, {1, 2, 4}, {0, 4, 6}, {1, 6, 7}, {0, 7, 8} };
+    ASSERT_EQ(buffer.size, (size_t)5);
+    for (size_t i = 0; i < 5; ++i) {
+        EXPECT_EQ(slices[i].pid, expected[i].pid) << "slice " << i;
+        EXPECT_EQ(slices[i].start, expected[i].start) << "slice " << i;
+        EXPECT_EQ(slices[i].end, expected[i].end) << "slice " << i;
+    }
+
+    // room for four slices is not enough
+    dyn_array_push_back(queue, &second);
+    dyn_array_push_back(queue, &first);
+    ASSERT_TRUE(schedule_timeline_to_buffer(&timeline, &buffer, slices, 4));
+    EXPECT_FALSE(round_robin_detailed(queue, &with, 2, &outputs));
+
+    dyn_array_destroy(copy);
+    dyn_array_destroy(queue);
+}
+
+/*
+Test 26:
+The timeline file decodes back to exactly the slices that were recorded
+*/
+TEST(Timeline_Test, FileRoundTrip)
+{
+    const char* input_filename = "/tmp/test_timeline_pcb.bin";
+    const char* timeline_filename = "/tmp/test_timeline.bin";
+
+    PcbGeneratorConfig_t config;
+    pcb_generator_defaults(&config, 5000, 9);
+    config.bursts = BURSTS_PARETO;
+    ASSERT_TRUE(pcb_generate_file(input_filename, &config));
+
+    // the same run into a buffer and into a file
+    std::vector<ScheduleSlice_t> slices(2000000);
+    ScheduleTimeline_t timeline;
+    ScheduleTimelineBuffer_t buffer;
+    ScheduleOutputs_t outputs = { &timeline, NULL };
+    ASSERT_TRUE(schedule_timeline_to_buffer(&timeline, &buffer, slices.data(), slices.size()));
+    dyn_array_t* queue = load_process_control_blocks(input_filename);
+    ScheduleResult_t result;
+    ASSERT_TRUE(shortest_remaining_time_first_detailed(queue, &result, &outputs));
+    dyn_array_destroy(queue);
+
+    FILE* f = fopen(timeline_filename, "wb");
+    ASSERT_NE(f, (FILE*)NULL);
+    schedule_timeline_writer_t* writer = schedule_timeline_writer_create(f);
+    ASSERT_TRUE(schedule_timeline_to_writer(&timeline, writer));
+    pcb_stream_t* stream = pcb_stream_open(input_filename);
+    ASSERT_TRUE(shortest_remaining_time_first_stream(stream, &result, &outputs));
+    pcb_stream_close(stream);
+    ASSERT_TRUE(schedule_timeline_writer_finish(writer));
+    long file_size = ftell(f);
+    fclose(f);
+
+    // every process shows up, and slices are a few bytes each
+    EXPECT_GE(buffer.size, (size_t)5000);
+    EXPECT_LT((size_t)file_size, buffer.size * 6);
+
+    f = fopen(timeline_filename, "rb");
+    ASSERT_NE(f, (FILE*)NULL);
+    schedule_timeline_reader_t* reader = schedule_timeline_reader_create(f);
+    ASSERT_NE(reader, (schedule_timeline_reader_t*)NULL);
+    ScheduleSlice_t slice;
+    size_t decoded = 0;
+    while (schedule_timeline_reader_next(reader, &slice)) {
+        ASSERT_LT(decoded, buffer.size);
+        EXPECT_EQ(slice.pid, slices[decoded].pid);
+        EXPECT_EQ(slice.start, slices[decoded].start);
+        EXPECT_EQ(slice.end, slices[decoded].end);
+        ++decoded;
+    }
+    EXPECT_FALSE(schedule_timeline_reader_failed(reader));
+    EXPECT_EQ(decoded, buffer.size);
+    schedule_timeline_reader_destroy(reader);
+    fclose(f);
+
+    // a file cut off in the middle of a slice is an error, not a short timeline
+    ASSERT_EQ(truncate(timeline_filename, file_size - 1), 0);
+    f = fopen(timeline_filename, "rb");
+    reader = schedule_timeline_reader_create(f);
+    ASSERT_NE(reader, (schedule_timeline_reader_t*)NULL);
+    while (schedule_timeline_reader_next(reader, &slice))
+        ;
+    EXPECT_TRUE(schedule_timeline_reader_failed(reader));
+    schedule_timeline_reader_destroy(reader);
+    fclose(f);
+
+    remove(input_filename);
+    remove(timeline_filename);
+}
+
+/*
+Test 27:
+The histogram stays within its error bound, and the extended stats match a hand worked run
+*/
+TEST(Stats_Test, QuantilesAndUtilisation)
+{
+    latency_histogram_t* histogram = latency_histogram_create();
+    ASSERT_NE(histogram, (latency_histogram_t*)NULL);
+    EXPECT_EQ(latency_histogram_quantile(histogram, 0.5), (uint64_t)0);
+    for (uint64_t value = 1; value <= 100000; ++value)
+        latency_histogram_record(histogram, value);
+    EXPECT_EQ(latency_histogram_count(histogram), (uint64_t)100000);
+    EXPECT_EQ(latency_histogram_max(histogram), (uint64_t)100000);
+    const double quantiles[] = { 0.5, 0.9, 0.99 };
+    for (double q : quantiles) {
+        uint64_t exact = (uint64_t)(q * 100000);
+        uint64_t reported = latency_histogram_quantile(histogram, q);
+        EXPECT_GE(reported, exact) << q;
+        EXPECT_LE(reported, exact + exact / 128) << q;
+    }
+    latency_histogram_destroy(histogram);
+
+    // pid 0 arrives at 0 with 5, pid 1 arrives at 1 with 3, same run as Test 25
+    dyn_array_t* queue = dyn_array_create(0, sizeof(ProcessControlBlock_t), nullptr);
+    ProcessControlBlock_t second = make_pcb(1, 3);
+    ProcessControlBlock_t first  = make_pcb(0, 5);
+    dyn_array_push_back(queue, &second);
+    dyn_array_push_back(queue, &first);
+
+    ScheduleResult_t result;
+    ScheduleStats_t stats;
+    ScheduleOutputs_t outputs = { NULL, &stats };
+    ASSERT_TRUE(round_robin_detailed(queue, &result, 2, &outputs));
+    // 0 finishes at 8, 1 at 7: turnaround 8 and 6, both spend 3 waiting, first dispatch after 0 and 1
+    EXPECT_EQ(stats.turnaround.p50, (uint64_t)6);
+    EXPECT_EQ(stats.turnaround.p90, (uint64_t)8);
+    EXPECT_EQ(stats.turnaround.max, (uint64_t)8);
+    EXPECT_EQ(stats.ready.p50, (uint64_t)3);
+    EXPECT_EQ(stats.ready.max, (uint64_t)3);
+    // ready counts the wait after the first dispatch too, response stops at it
+    EXPECT_EQ(stats.average_ready_time, 3.0);
+    EXPECT_EQ(stats.average_response_time, 0.5);
+    EXPECT_FLOAT_EQ(result.average_waiting_time, 0.5f);
+    EXPECT_EQ(stats.response.p50, (uint64_t)0);
+    EXPECT_EQ(stats.response.p99, (uint64_t)1);
+    EXPECT_FLOAT_EQ(stats.cpu_utilisation, 1.0f);
+
+    // FCFS with the CPU idle from 2 to 6 is busy half the time
+    ProcessControlBlock_t late  = make_pcb(6, 2);
+    ProcessControlBlock_t early = make_pcb(0, 2);
+    dyn_array_push_back(queue, &late);
+    dyn_array_push_back(queue, &early);
+    ASSERT_TRUE(first_come_first_serve_detailed(queue, &result, &outputs));
+    EXPECT_EQ(result.total_run_time, 8UL);
+    EXPECT_FLOAT_EQ(stats.cpu_utilisation, 0.5f);
+    EXPECT_EQ(stats.turnaround.max, (uint64_t)2);
+    EXPECT_EQ(stats.ready.max, (uint64_t)0);
+    dyn_array_destroy(queue);
+
+    // a streamed run reports the same stats as a loaded one
+    const char* input_filename = "/tmp/test_stats_pcb.bin";
+    PcbGeneratorConfig_t config;
+    pcb_generator_defaults(&config, 20000, 5);
+    config.bursts = BURSTS_PARETO;
+    ASSERT_TRUE(pcb_generate_file(input_filename, &config));
+    ScheduleStats_t streamed;
+    ScheduleOutputs_t streamed_outputs = { NULL, &streamed };
+    queue = load_process_control_blocks(input_filename);
+    ASSERT_TRUE(shortest_remaining_time_first_detailed(queue, &result, &outputs));
+    dyn_array_destroy(queue);
+    pcb_stream_t* stream = pcb_stream_open(input_filename);
+    ASSERT_TRUE(shortest_remaining_time_first_stream(stream, &result, &streamed_outputs));
+    pcb_stream_close(stream);
+    const ScheduleQuantiles_t* loaded_tails[] = { &stats.ready, &stats.turnaround, &stats.response };
+    const ScheduleQuantiles_t* streamed_tails[] = { &streamed.ready, &streamed.turnaround, &streamed.response };
+    for (size_t i = 0; i < 3; ++i) {
+        EXPECT_EQ(loaded_tails[i]->p50, streamed_tails[i]->p50) << i;
+        EXPECT_EQ(loaded_tails[i]->p90, streamed_tails[i]->p90) << i;
+        EXPECT_EQ(loaded_tails[i]->p99, streamed_tails[i]->p99) << i;
+        EXPECT_EQ(loaded_tails[i]->max, streamed_tails[i]->max) << i;
+    }
+    EXPECT_EQ(stats.cpu_utilisation, streamed.cpu_utilisation);
+    EXPECT_LE(stats.turnaround.p50, stats.turnaround.p90);
+    EXPECT_LE(stats.turnaround.p90, stats.turnaround.p99);
+    EXPECT_LE(stats.turnaround.p99, stats.turnaround.max);
+    remove(input_filename);
+}
+
+/*
+Test 28:
+Totals past 2^64 stay exact in every FCFS kernel and in the event loop
+*/
+TEST(Stats_Test, TotalsPastSixtyFourBits)
+{
+    // n jobs of the largest burst all arriving at 0: job i finishes at (i + 1) * burst, so the
+    // turnaround total is burst * n * (n + 1) / 2, about 2.6e21 and far past what 64 bits can hold
+    // the last finish times pass 2^52, where the kernels stop summing a chunk at a time
+    const uint64_t n = 1100000;
+    const uint64_t burst = UINT32_MAX;
+    const ScheduleTotal_t expected_turnaround = (ScheduleTotal_t)burst * (n * (n + 1) / 2);
+    const ScheduleTotal_t expected_waiting = (ScheduleTotal_t)burst * (n * (n - 1) / 2);
+    ASSERT_TRUE(expected_turnaround > (ScheduleTotal_t)UINT64_MAX);
+
+    dyn_array_t* queue = dyn_array_create(n, sizeof(ProcessControlBlock_t), nullptr);
+    ProcessControlBlock_t pcb = make_pcb(0, (uint32_t)burst);
+    for (uint64_t i = 0; i < n; ++i)
+        dyn_array_push_back(queue, &pcb);
+    dyn_array_t* copy = dyn_array_import(dyn_array_export(queue), n, sizeof(ProcessControlBlock_t), nullptr);
+
+    PcbColumns_t* columns = pcb_columns_from_queue(queue);
+    ASSERT_NE(columns, (PcbColumns_t*)NULL);
+    const FcfsKernel_t kernels[] = { FCFS_KERNEL_SCALAR, FCFS_KERNEL_AVX512 };
+    for (FcfsKernel_t kernel : kernels) {
+        FcfsTotals_t totals;
+        if (!fcfs_kernel_supported(kernel))
+            continue;
+        ASSERT_TRUE(fcfs_kernel_run(kernel, columns, &totals));
+        EXPECT_TRUE(totals.total_turnaround_time == expected_turnaround) << "kernel " << kernel;
+        EXPECT_TRUE(totals.total_waiting_time == expected_waiting) << "kernel " << kernel;
+    }
+    pcb_columns_destroy(columns);
+
+    // equal bursts keep SJF in queue order, so the event loop must land on the same totals
+    ScheduleResult_t result;
+    ScheduleStats_t stats;
+    ScheduleOutputs_t outputs = { NULL, &stats };
+    ASSERT_TRUE(shortest_job_first_detailed(copy, &result, &outputs));
+    EXPECT_EQ(stats.num_processes, n);
+    EXPECT_TRUE(stats.total_turnaround_time == expected_turnaround);
+    EXPECT_TRUE(stats.total_ready_time == expected_waiting);
+    EXPECT_TRUE(stats.total_response_time == expected_waiting);
+    EXPECT_EQ(stats.average_turnaround_time, (double)burst * (double)(n + 1) / 2.0);
+    EXPECT_EQ(stats.average_ready_time, (double)burst * (double)(n - 1) / 2.0);
+    EXPECT_EQ(result.average_turnaround_time, (float)((double)burst * (double)(n + 1) / 2.0));
+
+    ASSERT_TRUE(first_come_first_serve_detailed(queue, &result, &outputs));
+    EXPECT_TRUE(stats.total_turnaround_time == expected_turnaround);
+    EXPECT_EQ(stats.average_response_time, (double)burst * (double)(n - 1) / 2.0);
+
+    dyn_array_destroy(copy);
+    dyn_array_destroy(queue);
+}
+
+/*
+Test 29:
+Multi-core runs match one core when given one, and share work across cores when given more
+*/
+TEST(SMP_Test, CoresAndStealing)
+{
+    const char* input_filename = "/tmp/test_smp.bin";
+    PcbGeneratorConfig_t config;
+    pcb_generator_defaults(&config, 20000, 17);
+    config.bursts = BURSTS_PARETO;
+    ASSERT_TRUE(pcb_generate_file(input_filename, &config));
+
+    // one core, either queueing, is the single core scheduler
+    const SmpQueueing_t queueings[] = { SMP_GLOBAL_QUEUE, SMP_PER_CORE_QUEUES };
+    for (SmpQueueing_t queueing : queueings) {
+        for (int algorithm = 0; algorithm < 6; ++algorithm) {
+            dyn_array_t* queue = load_process_control_blocks(input_filename);
+            dyn_array_t* copy = load_process_control_blocks(input_filename);
+            ScheduleResult_t single, smp;
+            SmpCoreStats_t core;
+            const PriorityConfig_t priority_config = { algorithm == 5, 0 };
+            switch (algorithm) {
+            case 0:
+                ASSERT_TRUE(first_come_first_serve(queue, &single));
+                ASSERT_TRUE(first_come_first_serve_smp(copy, &smp, 1, queueing, &core));
+                break;
+            case 1:
+                ASSERT_TRUE(shortest_job_first(queue, &single));
+                ASSERT_TRUE(shortest_job_first_smp(copy, &smp, 1, queueing, &core));
+                break;
+            case 2:
+                ASSERT_TRUE(round_robin(queue, &single, 5));
+                ASSERT_TRUE(round_robin_smp(copy, &smp, 5, 1, queueing, &core));
+                break;
+            case 3:
+                ASSERT_TRUE(shortest_remaining_time_first(queue, &single));
+                ASSERT_TRUE(shortest_remaining_time_first_smp(copy, &smp, 1, queueing, &core));
+                break;
+            default:
+                ASSERT_TRUE(priority_detailed(queue, &single, &priority_config, nullptr));
+                ASSERT_TRUE(priority_smp(copy, &smp, &priority_config, 1, queueing, &core));
+                break;
+            }
+            EXPECT_EQ(single.average_waiting_time, smp.average_waiting_time) << "algorithm " << algorithm;
+            EXPECT_EQ(single.average_turnaround_time, smp.average_turnaround_time) << "algorithm " << algorithm;
+            EXPECT_EQ(single.total_run_time, smp.total_run_time) << "algorithm " << algorithm;
+            EXPECT_EQ(core.steals, (size_t)0);
+            dyn_array_destroy(queue);
+            dyn_array_destroy(copy);
+        }
+    }
+
+    // on 8 cores every burst is run exactly once, somewhere
+    dyn_array_t* queue = load_process_control_blocks(input_filename);
+    uint64_t total_burst = 0;
+    for (size_t i = 0; i < dyn_array_size(queue); ++i)
+        total_burst += ((const ProcessControlBlock_t*)dyn_array_at(queue, i))->remaining_burst_time;
+    for (SmpQueueing_t queueing : queueings) {
+        dyn_array_t* copy = dyn_array_import(dyn_array_export(queue), dyn_array_size(queue),
+                                             sizeof(ProcessControlBlock_t), nullptr);
+        ScheduleResult_t result;
+        SmpCoreStats_t cores[8];
+        ASSERT_TRUE(round_robin_smp(copy, &result, 5, 8, queueing, cores));
+        uint64_t busy = 0;
+        for (const SmpCoreStats_t& core : cores) {
+            busy += core.busy_time;
+            EXPECT_LE(core.utilisation, 1.0f);
+        }
+        EXPECT_EQ(busy, total_burst);
+        EXPECT_GE(result.total_run_time * 8, total_burst);
+        dyn_array_destroy(copy);
+    }
+    dyn_array_destroy(queue);
+    remove(input_filename);
+
+    // two cores sharing a queue: 0 and 1 start at once, 2 waits for the first core to free up at 4
+    queue = dyn_array_create(0, sizeof(ProcessControlBlock_t), nullptr);
+    ProcessControlBlock_t pcbs[] = { make_pcb(0, 2), make_pcb(0, 4), make_pcb(0, 4) };
+    for (const ProcessControlBlock_t& pcb : pcbs)
+        dyn_array_push_back(queue, &pcb);
+    ScheduleResult_t result;
+    SmpCoreStats_t cores[2];
+    ASSERT_TRUE(first_come_first_serve_smp(queue, &result, 2, SMP_GLOBAL_QUEUE, cores));
+    EXPECT_FLOAT_EQ(result.average_waiting_time, 4.0f / 3.0f);
+    EXPECT_FLOAT_EQ(result.average_turnaround_time, 14.0f / 3.0f);
+    EXPECT_EQ(result.total_run_time, 6UL);
+    EXPECT_EQ(cores[0].busy_time + cores[1].busy_time, (uint64_t)10);
+
+    // per-core queues: pids 0 and 2 go to core 0, 1 and 3 to core 1, which runs out first and steals 2
+    ProcessControlBlock_t steal[] = { make_pcb(0, 1), make_pcb(0, 1), make_pcb(0, 1), make_pcb(0, 10) };
+    for (const ProcessControlBlock_t& pcb : steal)
+        dyn_array_push_back(queue, &pcb);
+    ASSERT_TRUE(first_come_first_serve_smp(queue, &result, 2, SMP_PER_CORE_QUEUES, cores));
+    EXPECT_EQ(result.total_run_time, 10UL);
+    EXPECT_FLOAT_EQ(result.average_waiting_time, 0.75f);
+    EXPECT_EQ(cores[0].steals, (size_t)0);
+    EXPECT_EQ(cores[1].steals, (size_t)1);
+    EXPECT_EQ(cores[1].busy_time, (uint64_t)3);
+    EXPECT_FLOAT_EQ(cores[0].utilisation, 1.0f);
+
+    // two cores by priority: the arrival at 2 takes the core of the lowest priority job only when preemptive
+    ProcessControlBlock_t ranked[] = { make_pcb(2, 2), make_pcb(0, 5), make_pcb(0, 5) };
+    ranked[0].priority = 1;
+    ranked[1].priority = 3;
+    ranked[2].priority = 5;
+    for (bool preemptive : { false, true }) {
+        for (const ProcessControlBlock_t& pcb : ranked)
+            dyn_array_push_back(queue, &pcb);
+        const PriorityConfig_t priority_config = { preemptive, 0 };
+        ASSERT_TRUE(priority_smp(queue, &result, &priority_config, 2, SMP_GLOBAL_QUEUE, cores));
+        EXPECT_FLOAT_EQ(result.average_waiting_time, preemptive ? 0.0f : 1.0f);
+        EXPECT_FLOAT_EQ(result.average_turnaround_time, preemptive ? 14.0f / 3.0f : 15.0f / 3.0f);
+        EXPECT_EQ(result.total_run_time, 7UL);
+    }
+
+    // aging is not simulated across cores
+    for (const ProcessControlBlock_t& pcb : ranked)
+        dyn_array_push_back(queue, &pcb);
+    const PriorityConfig_t aging = { false, 10 };
+    EXPECT_FALSE(priority_smp(queue, &result, &aging, 2, SMP_GLOBAL_QUEUE, cores));
+    dyn_array_destroy(queue);
+}
+
+/*
+Test 30:
+MLFQ demotes jobs that use their whole quantum, boosts them back up, and with one level is round robin
+*/
+TEST(MLFQ_Test, DemotionAndBoost)
+{
+    const size_t quanta[] = { 2, 4 };
+    MlfqConfig_t config = { 2, quanta, 0 };
+    dyn_array_t* queue = dyn_array_create(0, sizeof(ProcessControlBlock_t), nullptr);
+    ScheduleResult_t result;
+
+    // pushed latest first, so the back of the queue is the first arrival
+    ProcessControlBlock_t pcbs[] = { make_pcb(5, 1), make_pcb(1, 2), make_pcb(0, 10) };
+    for (const ProcessControlBlock_t& pcb : pcbs)
+        dyn_array_push_back(queue, &pcb);
+    MlfqConfig_t no_levels = { 0, quanta, 0 };
+    EXPECT_FALSE(multilevel_feedback_queue(queue, &result, &no_levels));
+    const size_t zero_quantum[] = { 2, 0 };
+    MlfqConfig_t bad_quantum = { 2, zero_quantum, 0 };
+    EXPECT_FALSE(multilevel_feedback_queue(queue, &result, &bad_quantum));
+    ASSERT_TRUE(multilevel_feedback_queue(queue, &result, &config));
+
+    //0..2 (arr 0, drops a level), 2..4 (arr 1), 4..5 (arr 0 on level 1, cut by the arrival at 5),
+    //5..6 (arr 5 on the top level), 6..10 and 10..13 (arr 0)
+    //waiting until first dispatch: 0 + 1 + 0 = 1
+    //turnaround: 13 + 3 + 1 = 17
+    EXPECT_FLOAT_EQ(result.average_waiting_time, 1.0f / 3.0f);
+    EXPECT_FLOAT_EQ(result.average_turnaround_time, 17.0f / 3.0f);
+    EXPECT_EQ(result.total_run_time, 13UL);
+
+    // a long job sinks below a stream of short ones, the boost lets it cut back in ahead of the last two
+    const size_t long_quanta[] = { 2, 8 };
+    ProcessControlBlock_t stream[] = { make_pcb(10, 2), make_pcb(8, 2), make_pcb(6, 2), make_pcb(4, 2),
+                                       make_pcb(2, 2), make_pcb(0, 20) };
+    for (uint64_t boost : { (uint64_t)0, (uint64_t)5 }) {
+        for (const ProcessControlBlock_t& pcb : stream)
+            dyn_array_push_back(queue, &pcb);
+        MlfqConfig_t boosted = { 2, long_quanta, boost };
+        ASSERT_TRUE(multilevel_feedback_queue(queue, &result, &boosted));
+        EXPECT_FLOAT_EQ(result.average_waiting_time, boost == 0 ? 0.0f : 4.0f / 6.0f);
+        EXPECT_FLOAT_EQ(result.average_turnaround_time, boost == 0 ? 40.0f / 6.0f : 44.0f / 6.0f);
+        EXPECT_EQ(result.total_run_time, 30UL);
+    }
+    dyn_array_destroy(queue);
+
+    // one level is round robin, loaded or streamed
+    const char* input_filename = "/tmp/test_mlfq.bin";
+    PcbGeneratorConfig_t generator;
+    pcb_generator_defaults(&generator, 20000, 23);
+    ASSERT_TRUE(pcb_generate_file(input_filename, &generator));
+    const size_t one_level[] = { 5 };
+    MlfqConfig_t flat = { 1, one_level, 100 };
+    ScheduleResult_t rr, mlfq, streamed;
+    queue = load_process_control_blocks(input_filename);
+    ASSERT_TRUE(round_robin(queue, &rr, 5));
+    dyn_array_destroy(queue);
+    queue = load_process_control_blocks(input_filename);
+    ASSERT_TRUE(multilevel_feedback_queue(queue, &mlfq, &flat));
+    dyn_array_destroy(queue);
+    EXPECT_EQ(rr.average_waiting_time, mlfq.average_waiting_time);
+    EXPECT_EQ(rr.average_turnaround_time, mlfq.average_turnaround_time);
+    EXPECT_EQ(rr.total_run_time, mlfq.total_run_time);
+
+    config.boost_interval = 50;
+    queue = load_process_control_blocks(input_filename);
+    ASSERT_TRUE(multilevel_feedback_queue(queue, &mlfq, &config));
+    dyn_array_destroy(queue);
+    pcb_stream_t* pcb_stream = pcb_stream_open(input_filename);
+    ASSERT_NE(pcb_stream, nullptr);
+    ASSERT_TRUE(multilevel_feedback_queue_stream(pcb_stream, &streamed, &config, nullptr));
+    pcb_stream_close(pcb_stream);
+    EXPECT_EQ(mlfq.average_waiting_time, streamed.average_waiting_time);
+    EXPECT_EQ(mlfq.average_turnaround_time, streamed.average_turnaround_time);
+    EXPECT_EQ(mlfq.total_run_time, streamed.total_run_time);
+    remove(input_filename);
+}
+
+/*
+Test 31:
+Priority runs the lowest value first, preempts on arrivals when asked, and ages waiting jobs without rescans
+*/
+TEST(Priority_Test, PreemptionAndAging)
+{
+    dyn_array_t* queue = dyn_array_create(0, sizeof(ProcessControlBlock_t), nullptr);
+    ScheduleResult_t result;
+    EXPECT_FALSE(priority(queue, &result));
+
+    // (arrival, burst, priority), pushed latest first
+    const uint32_t jobs[][3] = { { 3, 1, 1 }, { 2, 2, 2 }, { 1, 3, 1 }, { 0, 4, 3 } };
+    for (bool preemptive : { false, true }) {
+        for (const uint32_t* job : jobs) {
+            ProcessControlBlock_t pcb = make_pcb(job[0], job[1]);
+            pcb.priority = job[2];
+            dyn_array_push_back(queue, &pcb);
+        }
+        PriorityConfig_t config = { preemptive, 0 };
+        ASSERT_TRUE(priority_detailed(queue, &result, &config, nullptr));
+        if (!preemptive) {
+            //0..4 (arr 0), 4..7 (arr 1), 7..8 (arr 3, same priority as arr 1), 8..10 (arr 2)
+            EXPECT_FLOAT_EQ(result.average_waiting_time, 13.0f / 4.0f);
+            EXPECT_FLOAT_EQ(result.average_turnaround_time, 23.0f / 4.0f);
+        } else {
+            //0..1 (arr 0), 1..4 (arr 1 preempts), 4..5 (arr 3), 5..7 (arr 2), 7..10 (arr 0)
+            EXPECT_FLOAT_EQ(result.average_waiting_time, 1.0f);
+            EXPECT_FLOAT_EQ(result.average_turnaround_time, 5.0f);
+        }
+        EXPECT_EQ(result.total_run_time, 10UL);
+    }
+
+    // a stream of urgent jobs keeps the low priority job (arr 0, priority 3) waiting until it has aged enough
+    const uint32_t starving[][3] = { { 6, 2, 0 }, { 4, 2, 0 }, { 2, 2, 0 }, { 0, 1, 3 }, { 0, 2, 0 } };
+    for (uint64_t aging : { (uint64_t)0, (uint64_t)1 }) {
+        for (const uint32_t* job : starving) {
+            ProcessControlBlock_t pcb = make_pcb(job[0], job[1]);
+            pcb.priority = job[2];
+            dyn_array_push_back(queue, &pcb);
+        }
+        PriorityConfig_t config = { false, aging };
+        ASSERT_TRUE(priority_detailed(queue, &result, &config, nullptr));
+        //no aging: it runs last at 8..9, aging by one level per tick: it beats the job arriving at 4 and runs 4..5
+        EXPECT_FLOAT_EQ(result.average_waiting_time, aging == 0 ? 8.0f / 5.0f : 6.0f / 5.0f);
+        EXPECT_FLOAT_EQ(result.average_turnaround_time, aging == 0 ? 17.0f / 5.0f : 3.0f);
+        EXPECT_EQ(result.total_run_time, 9UL);
+    }
+    dyn_array_destroy(queue);
+
+    // with a single priority level nothing ever outranks the earliest arrival, which is FCFS
+    const char* input_filename = "/tmp/test_priority.bin";
+    PcbGeneratorConfig_t generator;
+    pcb_generator_defaults(&generator, 20000, 29);
+    generator.priority_levels = 1;
+    ASSERT_TRUE(pcb_generate_file(input_filename, &generator));
+    ScheduleResult_t fcfs;
+    queue = load_process_control_blocks(input_filename);
+    ASSERT_TRUE(first_come_first_serve(queue, &fcfs));
+    dyn_array_destroy(queue);
+    for (uint64_t aging : { (uint64_t)0, (uint64_t)7 }) {
+        PriorityConfig_t config = { true, aging };
+        queue = load_process_control_blocks(input_filename);
+        ASSERT_TRUE(priority_detailed(queue, &result, &config, nullptr));
+        dyn_array_destroy(queue);
+        EXPECT_FLOAT_EQ(result.average_waiting_time, fcfs.average_waiting_time);
+        EXPECT_FLOAT_EQ(result.average_turnaround_time, fcfs.average_turnaround_time);
+        EXPECT_EQ(result.total_run_time, fcfs.total_run_time);
+    }
+
+    // preemption and aging together, loaded or streamed
+    generator.priority_levels = 32;
+    ASSERT_TRUE(pcb_generate_file(input_filename, &generator));
+    PriorityConfig_t config = { true, 25 };
+    ScheduleStats_t stats;
+    ScheduleOutputs_t outputs = { nullptr, &stats };
+    queue = load_process_control_blocks(input_filename);
+    ASSERT_TRUE(priority_detailed(queue, &result, &config, &outputs));
+    dyn_array_destroy(queue);
+    EXPECT_EQ(stats.num_processes, (uint64_t)20000);
+    ScheduleResult_t streamed;
+    pcb_stream_t* pcb_stream = pcb_stream_open(input_filename);
+    ASSERT_NE(pcb_stream, nullptr);
+    ASSERT_TRUE(priority_stream(pcb_stream, &streamed, &config, nullptr));
+    pcb_stream_close(pcb_stream);
+    EXPECT_EQ(result.average_waiting_time, streamed.average_waiting_time);
+    EXPECT_EQ(result.average_turnaround_time, streamed.average_turnaround_time);
+    EXPECT_EQ(result.total_run_time, streamed.total_run_time);
+    remove(input_filename);
+}
+
+/*
+Test 32:
+View schedulers read a strided trace in place, give the consuming results and leave the trace untouched
+*/
+TEST(View_Test, SharedTraceUntouched)
+{
+    const char* input_filename = "/tmp/test_view.bin";
+    PcbGeneratorConfig_t generator;
+    pcb_generator_defaults(&generator, 5000, 31);
+    ASSERT_TRUE(pcb_generate_file(input_filename, &generator));
+    dyn_array_t* queue = load_process_control_blocks(input_filename);
+    ASSERT_NE(queue, nullptr);
+    remove(input_filename);
+
+    // swap a few neighbours so the arrival-ordered policies have to sort
+    const size_t n = dyn_array_size(queue);
+    for (size_t i = 0; i + 1 < n; i += 97)
+        std::swap(*(ProcessControlBlock_t*)dyn_array_at(queue, i), *(ProcessControlBlock_t*)dyn_array_at(queue, i + 1));
+
+    // the same PCBs interleaved with other data, as a caller's own records might hold them
+    struct Record {
+        ProcessControlBlock_t pcb;
+        uint64_t tag;
+    };
+    std::vector<Record> records(n);
+    for (size_t i = 0; i < n; ++i) {
+        records[i].pcb = *(const ProcessControlBlock_t*)dyn_array_at(queue, i);
+        records[i].tag = i;
+    }
+    const std::vector<Record> pristine = records;
+    PcbView_t view = { records.data(), n, sizeof(Record) };
+    PcbView_t empty = { records.data(), 0, sizeof(Record) };
+    PcbView_t narrow = { records.data(), n, sizeof(ProcessControlBlock_t) - 1 };
+    ScheduleResult_t result;
+    EXPECT_FALSE(first_come_first_serve_view(&empty, &result, nullptr));
+    EXPECT_FALSE(shortest_job_first_view(&narrow, &result, nullptr));
+
+    const size_t quanta[] = { 4, 16 };
+    const MlfqConfig_t mlfq = { 2, quanta, 200 };
+    const PriorityConfig_t priority_config = { true, 50 };
+    for (int algorithm = 0; algorithm < 6; ++algorithm) {
+        dyn_array_t* copy = dyn_array_import(dyn_array_export(queue), n, sizeof(ProcessControlBlock_t), nullptr);
+        ScheduleResult_t consumed, viewed;
+        switch (algorithm) {
+        case 0:
+            ASSERT_TRUE(first_come_first_serve(copy, &consumed));
+            ASSERT_TRUE(first_come_first_serve_view(&view, &viewed, nullptr));
+            break;
+        case 1:
+            ASSERT_TRUE(shortest_job_first(copy, &consumed));
+            ASSERT_TRUE(shortest_job_first_view(&view, &viewed, nullptr));
+            break;
+        case 2:
+            ASSERT_TRUE(priority_detailed(copy, &consumed, &priority_config, nullptr));
+            ASSERT_TRUE(priority_view(&view, &viewed, &priority_config, nullptr));
+            break;
+        case 3:
+            ASSERT_TRUE(round_robin(copy, &consumed, 5));
+            ASSERT_TRUE(round_robin_view(&view, &viewed, 5, nullptr));
+            break;
+        case 4:
+            ASSERT_TRUE(shortest_remaining_time_first(copy, &consumed));
+            ASSERT_TRUE(shortest_remaining_time_first_view(&view, &viewed, nullptr));
+            break;
+        default:
+            ASSERT_TRUE(multilevel_feedback_queue(copy, &consumed, &mlfq));
+            ASSERT_TRUE(multilevel_feedback_queue_view(&view, &viewed, &mlfq, nullptr));
+            break;
+        }
+        EXPECT_EQ(dyn_array_size(copy), (size_t)0) << "algorithm " << algorithm;
+        EXPECT_EQ(consumed.average_waiting_time, viewed.average_waiting_time) << "algorithm " << algorithm;
+        EXPECT_EQ(consumed.average_turnaround_time, viewed.average_turnaround_time) << "algorithm " << algorithm;
+        EXPECT_EQ(consumed.total_run_time, viewed.total_run_time) << "algorithm " << algorithm;
+        dyn_array_destroy(copy);
+    }
+    EXPECT_EQ(memcmp(records.data(), pristine.data(), n * sizeof(Record)), 0);
+    dyn_array_destroy(queue);
+}
+
+/*
+Test 33:
+Bulk append and extract move whole runs in order, reserve only grows, and a clone is an independent copy
+*/
+TEST(DynArray_Test, BulkOperations)
+{
+    dyn_array_t* array = dyn_array_create(0, sizeof(uint32_t), nullptr);
+    ASSERT_NE(array, nullptr);
+    std::vector<uint32_t> values(1000);
+    for (size_t i = 0; i < values.size(); ++i)
+        values[i] = (uint32_t)i;
+
+    EXPECT_FALSE(dyn_array_push_back_n(nullptr, values.data(), 1));
+    EXPECT_FALSE(dyn_array_push_back_n(array, nullptr, 1));
+    EXPECT_TRUE(dyn_array_push_back_n(array, values.data(), 0));
+    EXPECT_EQ(dyn_array_size(array), (size_t)0);
+
+    // one run that has to grow the array past its first capacity, then a second behind it
+    ASSERT_TRUE(dyn_array_push_back_n(array, values.data(), 600));
+    ASSERT_TRUE(dyn_array_push_back_n(array, values.data() + 600, 400));
+    ASSERT_EQ(dyn_array_size(array), values.size());
+    EXPECT_EQ(memcmp(dyn_array_export(array), values.data(), values.size() * sizeof(uint32_t)), 0);
+
+    dyn_array_t* clone = dyn_array_clone(array);
+    ASSERT_NE(clone, nullptr);
+    EXPECT_EQ(dyn_array_clone(nullptr), nullptr);
+    EXPECT_EQ(dyn_array_size(clone), values.size());
+    EXPECT_EQ(dyn_array_data_size(clone), sizeof(uint32_t));
+
+    std::vector<uint32_t> extracted(values.size());
+    EXPECT_FALSE(dyn_array_extract_front_n(array, extracted.data(), values.size() + 1));
+    EXPECT_EQ(dyn_array_size(array), values.size());
+    ASSERT_TRUE(dyn_array_extract_front_n(array, extracted.data(), 10));
+    EXPECT_EQ(*(uint32_t*)dyn_array_front(array), 10u);
+    ASSERT_TRUE(dyn_array_extract_front_n(array, extracted.data() + 10, values.size() - 10));
+    EXPECT_TRUE(dyn_array_empty(array));
+    EXPECT_EQ(extracted, values);
+
+    // draining the original left the clone alone
+    EXPECT_EQ(memcmp(dyn_array_export(clone), values.data(), values.size() * sizeof(uint32_t)), 0);
+
+    EXPECT_FALSE(dyn_array_reserve(nullptr, 10));
+    ASSERT_TRUE(dyn_array_reserve(array, 5000));
+    EXPECT_GE(dyn_array_capacity(array), (size_t)5000);
+    EXPECT_EQ(dyn_array_size(array), (size_t)0);
+    size_t capacity = dyn_array_capacity(array);
+    EXPECT_TRUE(dyn_array_reserve(array, 10));
+    EXPECT_EQ(dyn_array_capacity(array), capacity);
+
+    dyn_array_destroy(clone);
+    dyn_array_destroy(array);
+}
+
+/*
+Test 34:
+Growth follows the array's policy, shrinking waits for the threshold and leaves room to grow, and drained queues let go
+*/
+TEST(DynArray_Test, GrowthAndShrinkPolicy)
+{
+    dyn_array_t* array = dyn_array_create(0, sizeof(uint32_t), nullptr);
+    ASSERT_NE(array, nullptr);
+    dyn_array_policy_t policy;
+    dyn_array_policy_defaults(&policy);
+    EXPECT_EQ(policy.growth_factor, 2.0);
+    EXPECT_EQ(policy.shrink_threshold, 0.0);
+
+    dyn_array_policy_t bad = policy;
+    bad.growth_factor = 1.0;
+    EXPECT_FALSE(dyn_array_set_policy(array, &bad));
+    bad = policy;
+    bad.shrink_threshold = 0.5; // a shrink to twice the size would land right back on the threshold
+    EXPECT_FALSE(dyn_array_set_policy(array, &bad));
+    bad = policy;
+    bad.min_capacity = 0;
+    EXPECT_FALSE(dyn_array_set_policy(array, &bad));
+    EXPECT_FALSE(dyn_array_set_policy(nullptr, &policy));
+
+    // a factor of 1.5 grows 16 -> 24 -> 36
+    policy.growth_factor = 1.5;
+    policy.shrink_threshold = 0.25;
+    ASSERT_TRUE(dyn_array_set_policy(array, &policy));
+    std::vector<uint32_t> values(1000, 7);
+    ASSERT_TRUE(dyn_array_push_back_n(array, values.data(), 17));
+    EXPECT_EQ(dyn_array_capacity(array), (size_t)24);
+    ASSERT_TRUE(dyn_array_push_back_n(array, values.data(), 8));
+    EXPECT_EQ(dyn_array_capacity(array), (size_t)36);
+
+    ASSERT_TRUE(dyn_array_push_back_n(array, values.data(), values.size() - 25));
+    size_t peak = dyn_array_capacity(array);
+    EXPECT_GE(peak, values.size());
+
+    // nothing is given back until the size falls under a quarter of the capacity
+    uint32_t value;
+    while (dyn_array_size(array) * 4 >= peak) {
+        EXPECT_EQ(dyn_array_capacity(array), peak);
+        ASSERT_TRUE(dyn_array_extract_back(array, &value));
+    }
+    size_t shrunk = dyn_array_capacity(array);
+    EXPECT_LT(shrunk, peak);
+    EXPECT_GT(shrunk, dyn_array_size(array));
+    // hysteresis: putting the last one back doesn't grow it again
+    ASSERT_TRUE(dyn_array_push_back(array, &value));
+    EXPECT_EQ(dyn_array_capacity(array), shrunk);
+
+    dyn_array_clear(array);
+    EXPECT_EQ(dyn_array_capacity(array), policy.min_capacity);
+
+    // explicit shrinking goes all the way, and an empty array keeps room for one
+    ASSERT_TRUE(dyn_array_push_back_n(array, values.data(), 100));
+    ASSERT_TRUE(dyn_array_shrink_to_fit(array));
+    EXPECT_EQ(dyn_array_capacity(array), (size_t)100);
+    EXPECT_EQ(memcmp(dyn_array_export(array), values.data(), 100 * sizeof(uint32_t)), 0);
+    dyn_array_destroy(array);
+    array = dyn_array_create(0, sizeof(uint32_t), nullptr);
+    ASSERT_TRUE(dyn_array_shrink_to_fit(array));
+    EXPECT_EQ(dyn_array_capacity(array), (size_t)1);
+    EXPECT_FALSE(dyn_array_shrink_to_fit(nullptr));
+
+    // large arrays can be placed on whole, aligned hugepages
+    const size_t hugepage = (size_t)2 << 20;
+    dyn_array_policy_defaults(&policy);
+    policy.hugepage_align = true;
+    ASSERT_TRUE(dyn_array_set_policy(array, &policy));
+    ASSERT_TRUE(dyn_array_push_back(array, &value));
+    ASSERT_TRUE(dyn_array_reserve(array, hugepage / sizeof(uint32_t) + 1));
+    EXPECT_EQ((uintptr_t)dyn_array_front(array) % hugepage, (uintptr_t)0);
+    EXPECT_EQ(dyn_array_capacity(array) * sizeof(uint32_t) % hugepage, (size_t)0);
+    EXPECT_EQ(*(uint32_t*)dyn_array_front(array), value);
+    dyn_array_destroy(array);
+
+    // a scheduler that used the queue up gives its memory back
+    dyn_array_t* queue = dyn_array_create(0, sizeof(ProcessControlBlock_t), nullptr);
+    for (uint32_t i = 0; i < 1000; ++i) {
+        ProcessControlBlock_t pcb = make_pcb(1000 - i, 3);
+        dyn_array_push_back(queue, &pcb);
+    }
+    ScheduleResult_t result;
+    ASSERT_TRUE(round_robin(queue, &result, 4));
+    EXPECT_TRUE(dyn_array_empty(queue));
+    EXPECT_LE(dyn_array_capacity(queue), (size_t)1);
+    dyn_array_destroy(queue);
+}
+
+/*
+Test 35:
+Arrays and rings on an arena grow in place and give everything back, and resetting between runs stops new blocks
+*/
+TEST(Arena_Test, ScratchReuse)
+{
+    EXPECT_EQ(dyn_arena_alloc(nullptr, 8), nullptr);
+    dyn_arena_t* arena = dyn_arena_create(65536);
+    ASSERT_NE(arena, nullptr);
+    EXPECT_EQ(dyn_arena_blocks(arena), (size_t)0);
+    EXPECT_EQ(dyn_arena_alloc(arena, 0), nullptr);
+
+    void* odd = dyn_arena_alloc(arena, 3);
+    void* next = dyn_arena_alloc(arena, 8);
+    ASSERT_NE(odd, nullptr);
+    ASSERT_NE(next, nullptr);
+    EXPECT_EQ((uintptr_t)next % alignof(max_align_t), (uintptr_t)0);
+    EXPECT_EQ(dyn_arena_blocks(arena), (size_t)1);
+    // too big for a block, it gets one of its own
+    ASSERT_NE(dyn_arena_alloc(arena, 100000), nullptr);
+    EXPECT_EQ(dyn_arena_blocks(arena), (size_t)2);
+    dyn_arena_reset(arena);
+    EXPECT_EQ(dyn_arena_used(arena), (size_t)0);
+
+    dyn_allocator_t allocator;
+    EXPECT_FALSE(dyn_arena_allocator(nullptr, &allocator));
+    ASSERT_TRUE(dyn_arena_allocator(arena, &allocator));
+    dyn_allocator_t broken = allocator;
+    broken.release = nullptr;
+    EXPECT_EQ(dyn_array_create_with_allocator(0, sizeof(uint32_t), nullptr, &broken), nullptr);
+
+    // growing the latest allocation doesn't move it, and destroying in reverse gives every byte back
+    dyn_array_t* array = dyn_array_create_with_allocator(0, sizeof(uint32_t), nullptr, &allocator);
+    ASSERT_NE(array, nullptr);
+    uint32_t value = 1;
+    ASSERT_TRUE(dyn_array_push_back(array, &value));
+    const void* before = dyn_array_front(array);
+    std::vector<uint32_t> values(500, 9);
+    ASSERT_TRUE(dyn_array_push_back_n(array, values.data(), values.size()));
+    EXPECT_EQ(dyn_array_front(array), before);
+    EXPECT_EQ(*(uint32_t*)dyn_array_front(array), value);
+    dyn_array_t* clone = dyn_array_clone(array);
+    ASSERT_NE(clone, nullptr);
+    EXPECT_EQ(memcmp(dyn_array_export(clone), dyn_array_export(array), 501 * sizeof(uint32_t)), 0);
+    dyn_array_destroy(clone);
+    dyn_array_destroy(array);
+    EXPECT_EQ(dyn_arena_used(arena), (size_t)0);
+
+    dyn_ring_t* ring = dyn_ring_create_with_allocator(0, sizeof(uint32_t), nullptr, &allocator);
+    ASSERT_NE(ring, nullptr);
+    for (uint32_t i = 0; i < 100; ++i)
+        ASSERT_TRUE(dyn_ring_push_back(ring, &i));
+    for (uint32_t i = 0; i < 100; ++i) {
+        ASSERT_TRUE(dyn_ring_extract_front(ring, &value));
+        EXPECT_EQ(value, i);
+    }
+    dyn_ring_destroy(ring);
+    EXPECT_EQ(dyn_arena_used(arena), (size_t)0);
+
+    // out of order scratch on the calling thread: the first run grows the arena, the rest reuse it
+    const size_t n = 2000;
+    std::vector<ProcessControlBlock_t> pcbs;
+    for (size_t i = 0; i < n; ++i)
+        pcbs.push_back(make_pcb((uint32_t)((i * 7919) % n), (uint32_t)(i % 13 + 1)));
+    PcbView_t view = { pcbs.data(), n, sizeof(ProcessControlBlock_t) };
+    ScheduleResult_t heap, scratch;
+    dyn_arena_reset(arena);
+    ASSERT_TRUE(round_robin_view(&view, &heap, 4, nullptr));
+    sim_set_scratch_allocator(&allocator);
+    EXPECT_NE(sim_scratch_allocator(), nullptr);
+    size_t blocks = 0;
+    for (int round = 0; round < 5; ++round) {
+        ASSERT_TRUE(round_robin_view(&view, &scratch, 4, nullptr));
+        EXPECT_GT(dyn_arena_used(arena), (size_t)0);
+        dyn_arena_reset(arena);
+        if (round == 0)
+            blocks = dyn_arena_blocks(arena);
+        EXPECT_EQ(dyn_arena_blocks(arena), blocks);
+    }
+    sim_set_scratch_allocator(nullptr);
+    EXPECT_EQ(sim_scratch_allocator(), nullptr);
+    EXPECT_EQ(heap.average_waiting_time, scratch.average_waiting_time);
+    EXPECT_EQ(heap.average_turnaround_time, scratch.average_turnaround_time);
+    EXPECT_EQ(heap.total_run_time, scratch.total_run_time);
+    dyn_arena_destroy(arena);
+}
+
+/*
+Test 36:
+The comparison sort agrees with std::sort at every object size, and the key sort is stable for every key width
+*/
+// an N byte object, its key in the first 4 bytes and the low byte of the key repeated after it
+template <size_t N>
+struct SortObject {
+    uint8_t bytes[N];
+    uint32_t key() const {
+        uint32_t key;
+        memcpy(&key, bytes, sizeof(key));
+        return key;
+    }
+};
+
+template <size_t N>
+static int compare_sort_object(const void* a, const void* b) {
+    const uint32_t lhs = ((const SortObject<N>*)a)->key();
+    const uint32_t rhs = ((const SortObject<N>*)b)->key();
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+template <size_t N>
+static void check_sort(const std::vector<uint32_t>& keys) {
+    std::vector<SortObject<N>> objects(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        memset(objects[i].bytes, (int)(keys[i] & 0xFF), N);
+        memcpy(objects[i].bytes, &keys[i], sizeof(keys[i]));
+    }
+    dyn_array_t* array = dyn_array_import(objects.data(), objects.size(), sizeof(SortObject<N>), nullptr);
+    ASSERT_NE(array, nullptr);
+    ASSERT_TRUE(dyn_array_sort(array, compare_sort_object<N>));
+    std::vector<uint32_t> expected(keys);
+    std::sort(expected.begin(), expected.end());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        const SortObject<N>* object = (const SortObject<N>*)dyn_array_at(array, i);
+        ASSERT_EQ(object->key(), expected[i]) << "size " << N << " at " << i;
+        // whole objects moved, not just their keys
+        ASSERT_EQ(object->bytes[N - 1], N > 4 ? (uint8_t)(expected[i] & 0xFF) : (uint8_t)(expected[i] >> 24));
+    }
+    dyn_array_destroy(array);
+}
+
+TEST(DynArray_Test, SortPaths)
+{
+    std::mt19937 rng(7);
+    std::vector<std::vector<uint32_t>> inputs;
+    std::vector<uint32_t> keys(5000);
+    for (uint32_t& key : keys)
+        key = rng();
+    inputs.push_back(keys);
+    for (uint32_t& key : keys)
+        key = rng() % 4; // mostly duplicates
+    inputs.push_back(keys);
+    for (size_t i = 0; i < keys.size(); ++i)
+        keys[i] = (uint32_t)i;
+    inputs.push_back(keys);
+    std::reverse(keys.begin(), keys.end());
+    inputs.push_back(keys);
+    inputs.push_back(std::vector<uint32_t>(3, 1));
+    for (const std::vector<uint32_t>& input : inputs) {
+        check_sort<4>(input);
+        check_sort<12>(input);
+        check_sort<16>(input);
+        check_sort<32>(input);
+        check_sort<100>(input);
+    }
+
+    // key sort: every width and an offset key, equal keys stay in input order
+    struct Keyed {
+        uint32_t seq;
+        uint8_t k1;
+        uint16_t k2;
+        uint32_t k4;
+        uint64_t k8;
+    };
+    std::vector<Keyed> records(3000);
+    for (size_t i = 0; i < records.size(); ++i) {
+        const uint32_t r = rng() % 50;
+        records[i] = { (uint32_t)i, (uint8_t)r, (uint16_t)(r * 1000), r << 20, (uint64_t)r << 40 };
+    }
+    const size_t offsets[] = { offsetof(Keyed, k1), offsetof(Keyed, k2), offsetof(Keyed, k4), offsetof(Keyed, k8) };
+    const size_t widths[] = { 1, 2, 4, 8 };
+    for (int k = 0; k < 4; ++k) {
+        dyn_array_t* array = dyn_array_import(records.data(), records.size(), sizeof(Keyed), nullptr);
+        ASSERT_NE(array, nullptr);
+        ASSERT_TRUE(dyn_array_sort_by_key(array, offsets[k], widths[k]));
+        std::vector<Keyed> expected(records);
+        std::stable_sort(expected.begin(), expected.end(), [](const Keyed& a, const Keyed& b) { return a.k1 < b.k1; });
+        for (size_t i = 0; i < expected.size(); ++i)
+            ASSERT_EQ(((const Keyed*)dyn_array_at(array, i))->seq, expected[i].seq) << "width " << widths[k];
+        dyn_array_destroy(array);
+    }
+
+    dyn_array_t* array = dyn_array_import(records.data(), records.size(), sizeof(Keyed), nullptr);
+    EXPECT_FALSE(dyn_array_sort_by_key(nullptr, 0, 4));
+    EXPECT_FALSE(dyn_array_sort_by_key(array, 0, 3));
+    EXPECT_FALSE(dyn_array_sort_by_key(array, sizeof(Keyed) - 2, 4));
+    EXPECT_TRUE(dyn_array_sort_by_key(array, sizeof(Keyed) - 8, 8));
+    dyn_array_destroy(array);
+}
+
 /*
 unsigned int score;
 unsigned int total;
@@ -164,6 +1835,84 @@ class GradeEnvironment : public testing::Environment
 */
 
 
+/*
+Test 37:
+An arrival preempts an MLFQ job that has sunk below the top level, which keeps its level and its place
+*/
+TEST(MLFQ_Test, ArrivalPreemptsLowerLevel)
+{
+    const size_t quanta[] = { 2, 100, 100 };
+    MlfqConfig_t config = { 3, quanta, 0 };
+    dyn_array_t* queue = dyn_array_create(0, sizeof(ProcessControlBlock_t), nullptr);
+
+    // pid 0 and 1 arrive at 0 with 30, pid 2 arrives at 10 with 2
+    ProcessControlBlock_t pcbs[] = { make_pcb(10, 2), make_pcb(0, 30), make_pcb(0, 30) };
+    for (const ProcessControlBlock_t& pcb : pcbs)
+        dyn_array_push_back(queue, &pcb);
+
+    ScheduleSlice_t slices[8];
+    ScheduleTimeline_t timeline;
+    ScheduleTimelineBuffer_t buffer;
+    ScheduleOutputs_t outputs = { &timeline, NULL };
+    ScheduleResult_t result;
+    ASSERT_TRUE(schedule_timeline_to_buffer(&timeline, &buffer, slices, 8));
+    ASSERT_TRUE(multilevel_feedback_queue_detailed(queue, &result, &config, &outputs));
+
+    // 0 and 1 sink after two ticks, 0 gets a 100 tick slice on level 1 but 2 is dispatched the moment it arrives,
+    // then 0 goes on ahead of 1, still on level 1, rather than sinking behind it
+    const ScheduleSlice_t expected[] = { {0, 0, 2}, {1, 2, 4}, {0, 4, 10}, {2, 10, 12}, {0, 12, 34}, {1, 34, 62} };
+    ASSERT_EQ(buffer.size, (size_t)6);
+    for (size_t i = 0; i < 6; ++i) {
+        EXPECT_EQ(slices[i].pid, expected[i].pid) << "slice " << i;
+        EXPECT_EQ(slices[i].start, expected[i].start) << "slice " << i;
+        EXPECT_EQ(slices[i].end, expected[i].end) << "slice " << i;
+    }
+    //waiting until first dispatch: 0 + 2 + 0 = 2
+    //turnaround: 34 + 62 + 2 = 98
+    EXPECT_FLOAT_EQ(result.average_waiting_time, 2.0f / 3.0f);
+    EXPECT_FLOAT_EQ(result.average_turnaround_time, 98.0f / 3.0f);
+    EXPECT_EQ(result.total_run_time, 62UL);
+    dyn_array_destroy(queue);
+}
+
+/*
+Test 38:
+An MLFQ job that arrivals keep cutting short still sinks once it has run a whole quantum on its level
+*/
+TEST(MLFQ_Test, CutSlicesCountTowardDemotion)
+{
+    const size_t quanta[] = { 2, 10, 3 };
+    MlfqConfig_t config = { 3, quanta, 0 };
+    dyn_array_t* queue = dyn_array_create(0, sizeof(ProcessControlBlock_t), nullptr);
+
+    // pid 0 arrives at 0 with 40, pids 1 to 4 arrive every 5 ticks with 1 each
+    ProcessControlBlock_t pcbs[] = { make_pcb(20, 1), make_pcb(15, 1), make_pcb(10, 1), make_pcb(5, 1), make_pcb(0, 40) };
+    for (const ProcessControlBlock_t& pcb : pcbs)
+        dyn_array_push_back(queue, &pcb);
+
+    ScheduleSlice_t slices[32];
+    ScheduleTimeline_t timeline;
+    ScheduleTimelineBuffer_t buffer;
+    ScheduleOutputs_t outputs = { &timeline, NULL };
+    ScheduleResult_t result;
+    ASSERT_TRUE(schedule_timeline_to_buffer(&timeline, &buffer, slices, 32));
+    ASSERT_TRUE(multilevel_feedback_queue_detailed(queue, &result, &config, &outputs));
+
+    // on level 1, 0 is cut at 5 and 10 after 3 and 4 ticks, so it only gets the 3 left of its 10 at 11
+    // and then sinks to level 2, where its 3 tick quantum is cut at 15 and finished off at 16..18
+    // without the carried quantum it would be cut every 5 ticks on level 1 and never sink
+    const ScheduleSlice_t expected[] = { {0, 0, 2}, {0, 2, 5}, {1, 5, 6}, {0, 6, 10}, {2, 10, 11},
+                                         {0, 11, 14}, {0, 14, 15}, {3, 15, 16}, {0, 16, 18} };
+    ASSERT_GE(buffer.size, (size_t)9);
+    for (size_t i = 0; i < 9; ++i) {
+        EXPECT_EQ(slices[i].pid, expected[i].pid) << "slice " << i;
+        EXPECT_EQ(slices[i].start, expected[i].start) << "slice " << i;
+        EXPECT_EQ(slices[i].end, expected[i].end) << "slice " << i;
+    }
+    EXPECT_EQ(result.total_run_time, 44UL);
+    dyn_array_destroy(queue);
+}
+
 int main(int argc, char **argv)
 {
 	::testing::InitGoogleTest(&argc, argv);